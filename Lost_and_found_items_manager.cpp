@@ -41,6 +41,23 @@ functions, file handling, and control flow.
 #include <cstring>
 #include <limits>
 #include <cctype>
+#include <cstdlib>
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <unordered_map>
+#include <random>
+#include <chrono>
+#include <bitset>
+#include <cmath>
+#include <functional>
+#include <thread>
+#include <climits>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
 
 
 using namespace std;
@@ -56,7 +73,7 @@ struct Item {
     string name;
     string category;
     string description;
-    char date[12];   // YYYY-MM-DD
+    int date;        // days since 1970-01-01, shown as YYYY-MM-DD
     string location;
     string status; // "Lost" or "Found"
     int matched;     // 0 = No, 1 = Yes
@@ -64,6 +81,11 @@ struct Item {
     int matchedItemID;
     string personName;
     string personContact;
+    bool hasCoordinates;  // latitude/longitude are optional
+    double latitude;
+    double longitude;
+
+    Item() : hasCoordinates(false), latitude(0.0), longitude(0.0) {}
 };
 
 const string CATEGORIES[] = {
@@ -104,6 +126,35 @@ bool containsSubstring(const string &str, const string &substr) {
     return lowerStr.find(lowerSub) != string::npos;
 }
 
+// Canonical form of a phone number or email so the same contact always compares equal:
+// emails are lower-cased without spaces, phone numbers keep only their digits
+string normalizeContact(const string& contact) {
+    string result;
+    bool isEmail = contact.find('@') != string::npos;
+    bool isPhone = !isEmail;
+    bool hasDigit = false;
+
+    for (size_t i = 0; i < contact.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(contact[i]);
+        if (isdigit(c)) hasDigit = true;
+        else if (!isspace(c) && string("+-().").find(static_cast<char>(c)) == string::npos) isPhone = false;
+    }
+
+    for (size_t i = 0; i < contact.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(contact[i]);
+        if (isPhone && hasDigit) {
+            if (isdigit(c)) result += static_cast<char>(c);
+        } else if (!isspace(c) || !isEmail) {
+            result += static_cast<char>(tolower(c));
+        }
+    }
+
+    // Free text that is neither: keep it, just trimmed and lower-cased
+    size_t start = result.find_first_not_of(' ');
+    if (start == string::npos) return "";
+    return result.substr(start, result.find_last_not_of(' ') - start + 1);
+}
+
 void selectCategory(string& category) {
     int choice;
 
@@ -139,53 +190,139 @@ void getInput(string &input, const string &prompt, bool optional = false) {
     }
 }
 
-void getValidDate(const char* prompt, char* date) {
-    string temp;
-    while (true) {
-        getInput(temp, prompt); // get string input
+// Dates are stored as days since 1970-01-01 and only turned into YYYY-MM-DD for display
 
-        //  Check format YYYY-MM-DD 
-        if (temp.length() != 10 || temp[4] != '-' || temp[7] != '-') {
-            cout << "Invalid date format! Use YYYY-MM-DD.\n";
-            continue;
-        }
+constexpr int DAYS_BEFORE_MONTH[2][13] = {
+    {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365},   // common year
+    {0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335, 366}    // leap year
+};
 
+constexpr bool isLeapYear(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
+}
 
-        // Check all year digits
-        if (!isdigit(temp[0]) || !isdigit(temp[1]) || !isdigit(temp[2]) || !isdigit(temp[3]) ||
-            !isdigit(temp[5]) || !isdigit(temp[6]) ||
-            !isdigit(temp[8]) || !isdigit(temp[9])) {
-            cout << "Date contains invalid characters! Must be digits.\n";
-            continue;
-        }
+constexpr int leapYearsBefore(int year) {
+    return (year - 1) / 4 - (year - 1) / 100 + (year - 1) / 400;
+}
 
+constexpr int daysFromCivil(int year, int month, int day) {
+    return 365 * (year - 1970) + leapYearsBefore(year) - leapYearsBefore(1970)
+         + DAYS_BEFORE_MONTH[isLeapYear(year) ? 1 : 0][month - 1] + day - 1;
+}
 
-        // --- Extract year, month, day ---
-        int year = (temp[0]-'0')*1000 + (temp[1]-'0')*100 + (temp[2]-'0')*10 + (temp[3]-'0');
-        int month = (temp[5]-'0')*10 + (temp[6]-'0');
-        int day = (temp[8]-'0')*10 + (temp[9]-'0');
+static_assert(daysFromCivil(1970, 1, 1) == 0, "epoch must be day 0");
+static_assert(daysFromCivil(2000, 3, 1) == 11017, "leap day handling");
 
-        // --- Validate month ---
-        if (month < 1 || month > 12) {
-            cout << "Invalid month! Must be 01-12.\n";
-            continue;
+// Shared by interactive input and file import. Returns false with a message on bad input.
+bool parseDate(const string& text, int& dayNumber, string& error) {
+    //  Check format YYYY-MM-DD 
+    if (text.length() != 10 || text[4] != '-' || text[7] != '-') {
+        error = "Invalid date format! Use YYYY-MM-DD.";
+        return false;
+    }
+
+    // Check all digits
+    static const int DIGIT_POSITIONS[] = {0, 1, 2, 3, 5, 6, 8, 9};
+    for (int i = 0; i < 8; i++) {
+        if (!isdigit(static_cast<unsigned char>(text[DIGIT_POSITIONS[i]]))) {
+            error = "Date contains invalid characters! Must be digits.";
+            return false;
         }
+    }
 
-        // --- Validate day ---
-        int daysInMonth[] = {31,28,31,30,31,30,31,31,30,31,30,31};
-        // Leap year check
-        if ((year % 4 == 0 && year % 100 != 0) || (year % 400 == 0))
-            daysInMonth[1] = 29;
+    int year = (text[0]-'0')*1000 + (text[1]-'0')*100 + (text[2]-'0')*10 + (text[3]-'0');
+    int month = (text[5]-'0')*10 + (text[6]-'0');
+    int day = (text[8]-'0')*10 + (text[9]-'0');
 
-        if (day < 1 || day > daysInMonth[month-1]) {
-            cout << "Invalid day for the given month!\n";
-            continue;
-        }
+    if (year < 1) {
+        error = "Invalid year! Must be 0001 or later.";
+        return false;
+    }
+    if (month < 1 || month > 12) {
+        error = "Invalid month! Must be 01-12.";
+        return false;
+    }
+
+    int leap = isLeapYear(year) ? 1 : 0;
+    if (day < 1 || day > DAYS_BEFORE_MONTH[leap][month] - DAYS_BEFORE_MONTH[leap][month - 1]) {
+        error = "Invalid day for the given month!";
+        return false;
+    }
+
+    dayNumber = daysFromCivil(year, month, day);
+    return true;
+}
+
+// Inverse of daysFromCivil, counted in 400-year eras starting on March 1st
+void civilFromDays(int dayNumber, int& year, int& month, int& day) {
+    int z = dayNumber + 719468;
+    int era = (z >= 0 ? z : z - 146096) / 146097;
+    int dayOfEra = z - era * 146097;
+    int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int shiftedMonth = (5 * dayOfYear + 2) / 153;
+
+    day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+    month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+    year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+}
 
-        // --- If all checks passed, copy to char array ---
-        strncpy(date, temp.c_str(), 11); // 10 chars + null terminator
-        date[11] = '\0';
-        break; // exit loop
+string formatDate(int dayNumber) {
+    int year, month, day;
+    civilFromDays(dayNumber, year, month, day);
+
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d", year, month, day);
+    return buffer;
+}
+
+// Months since year 0, used to bucket dates by calendar month
+int monthKeyOf(int dayNumber) {
+    int year, month, day;
+    civilFromDays(dayNumber, year, month, day);
+    return year * 12 + (month - 1);
+}
+
+void getValidDate(const char* prompt, int& date) {
+    string temp, error;
+    while (true) {
+        getInput(temp, prompt); // get string input
+
+        if (parseDate(temp, date, error))
+            break; // exit loop
+
+        cout << error << "\n";
+    }
+}
+
+// "lat, lon" in decimal degrees, e.g. 51.5072, -0.1276
+bool parseCoordinates(const string& text, double& latitude, double& longitude, string& error) {
+    char extra;
+    if (sscanf(text.c_str(), " %lf , %lf %c", &latitude, &longitude, &extra) != 2) {
+        error = "Enter latitude and longitude separated by a comma, e.g. 51.5072, -0.1276";
+        return false;
+    }
+    if (latitude < -90.0 || latitude > 90.0 || longitude < -180.0 || longitude > 180.0) {
+        error = "Latitude must be within -90..90 and longitude within -180..180";
+        return false;
+    }
+    return true;
+}
+
+// Optional; an empty answer removes the coordinates
+void getCoordinates(Item& item, const char* prompt) {
+    string temp, error;
+    while (true) {
+        getInput(temp, prompt, true);
+        if (temp.empty()) {
+            item.hasCoordinates = false;
+            return;
+        }
+        if (parseCoordinates(temp, item.latitude, item.longitude, error)) {
+            item.hasCoordinates = true;
+            return;
+        }
+        cout << error << "\n";
     }
 }
 
@@ -221,8 +358,9 @@ void displayItem(const Item& item) {
     cout << "Name:      " << item.name << "\n";
     cout << "Category:  " << item.category << "\n";
     cout << "Description:\n" << item.description << "\n";
-    cout << "Date:      " << item.date << "\n";
+    cout << "Date:      " << formatDate(item.date) << "\n";
     cout << "Location:  " << item.location << "\n";
+    if (item.hasCoordinates) printf("Position:  %.6f, %.6f\n", item.latitude, item.longitude);
     cout << "Status:    " << item.status << "\n";
     cout << "Matched:   " << (item.matched ? "Yes" : "No") << "\n";
     cout << "Claimed:   " << (item.claimed ? "Yes" : "No") << "\n";
@@ -235,7 +373,27 @@ void displayItem(const Item& item) {
     cout << "------------------------------------------------------------------------------------------------------------------------------\n\n";
 }
 
-void displayResults(Item items[], int results[], int count) {
+void displayResultRow(const Item& item) {
+    cout << "ID: " << item.id << "\n";
+    cout << "Name: " << item.name << "\n";
+    cout << "Category: " << item.category << "\n";
+    cout << "Description: " << item.description << "\n";
+    cout << "Date: " << formatDate(item.date) << "\n";
+    cout << "Location: " << item.location << "\n";
+    if (item.hasCoordinates) printf("Position: %.6f, %.6f\n", item.latitude, item.longitude);
+    cout << "Status: " << item.status << "\n";
+    cout << "Matched: " << (item.matched ? "Yes" : "No") << "\n";
+    cout << "Claimed: " << (item.claimed ? "Yes" : "No") << "\n";
+    if (item.matchedItemID != -1)
+        cout << "Matched With ID: " << item.matchedItemID << "\n";
+    cout << "Person: " << item.personName << " | Contact: " << item.personContact << "\n";
+    cout << "------------------------------------------------------------------------------------------------------------------------------\n";
+}
+
+struct ItemIndex;
+void displayFacets(const ItemIndex& index, const int results[], int count); // defined with the indexes
+
+void displayResults(Item items[], int results[], int count, const ItemIndex* index = NULL) {
     if (count == 0) {
         cout << "No items found matching criteria.\n";
         return;
@@ -245,22 +403,10 @@ cout << "\n=====================================================================
     cout << "\n========== SEARCH / FILTER RESULTS ==========\n";
 
     for (int i = 0; i < count; i++) {
-        int idx = results[i]; // always use results array
-
-        cout << "ID: " << items[idx].id << "\n";
-        cout << "Name: " << items[idx].name << "\n";
-        cout << "Category: " << items[idx].category << "\n";
-        cout << "Description: " << items[idx].description << "\n";
-        cout << "Date: " << items[idx].date << "\n";
-        cout << "Location: " << items[idx].location << "\n";
-        cout << "Status: " << items[idx].status << "\n";
-        cout << "Matched: " << (items[idx].matched ? "Yes" : "No") << "\n";
-        cout << "Claimed: " << (items[idx].claimed ? "Yes" : "No") << "\n";
-        if (items[idx].matchedItemID != -1)
-            cout << "Matched With ID: " << items[idx].matchedItemID << "\n";
-        cout << "Person: " << items[idx].personName << " | Contact: " << items[idx].personContact << "\n";
-        cout << "------------------------------------------------------------------------------------------------------------------------------\n";
+        displayResultRow(items[results[i]]); // always use results array
     }
+
+    if (index) displayFacets(*index, results, count);
 }
 
 Item* getItemByID(Item items[], int itemCount, int id) {
@@ -271,6 +417,11 @@ Item* getItemByID(Item items[], int itemCount, int id) {
     return NULL; // return nullptr if no item with the given ID is found
 }
 
+// Milliseconds since start, for traces and benchmarks
+double elapsedMs(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
 
 
 
@@ -293,228 +444,398 @@ void resizeArray(Item*& items, int& capacity) {
 
 
 
-// File Operations
-
-void saveToFile(fstream& file, Item* items, int itemCount, int nextID, const char* filename) {
-    file.open(filename, ios::out | ios::binary);
-    if (!file) {
-        cout << "File can't be opened.\n";
-        return;
-    }
-
-    // header
-    file.write(reinterpret_cast<char*>(&nextID), sizeof(nextID));
-    file.write(reinterpret_cast<char*>(&itemCount), sizeof(itemCount));
-
-    for (int i = 0; i < itemCount; i++) {
-
-        // id
-        file.write(reinterpret_cast<char*>(&items[i].id), sizeof(items[i].id));
-
-        // name
-        size_t len = items[i].name.length();
-        file.write(reinterpret_cast<char*>(&len), sizeof(len));
-        file.write(items[i].name.c_str(), len);
-
-        // category
-        len = items[i].category.length();
-        file.write(reinterpret_cast<char*>(&len), sizeof(len));
-        file.write(items[i].category.c_str(), len);
+// Compressed Bitmaps (roaring-style)
+// A slot number is split into a 16-bit container key and a 16-bit low part.
+// Each container keeps its low parts as a sorted array while sparse and
+// switches to a fixed 1024-word bitset once it holds more than 4096 values.
 
-        // description
-        len = items[i].description.length();
-        file.write(reinterpret_cast<char*>(&len), sizeof(len));
-        file.write(items[i].description.c_str(), len);
+const int BITMAP_ARRAY_LIMIT = 4096;
+const int BITMAP_WORDS = 1024;
 
-        // date (fixed array)
-        file.write(items[i].date, sizeof(items[i].date));
+struct BitmapContainer {
+    unsigned short key;                 // high 16 bits of the slot
+    bool dense;                         // true = bitset, false = sorted array
+    vector<unsigned short> values;      // sparse form
+    vector<unsigned long long> words;   // dense form (BITMAP_WORDS words)
+    int cardinality;
+};
 
-        // location
-        len = items[i].location.length();
-        file.write(reinterpret_cast<char*>(&len), sizeof(len));
-        file.write(items[i].location.c_str(), len);
+struct Bitmap {
+    vector<BitmapContainer> containers; // sorted by key
+};
 
-        // status
-        len = items[i].status.length();
-        file.write(reinterpret_cast<char*>(&len), sizeof(len));
-        file.write(items[i].status.c_str(), len);
+int countBits(unsigned long long word) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(word);
+#else
+    int count = 0;
+    while (word) {
+        word &= word - 1;
+        count++;
+    }
+    return count;
+#endif
+}
 
-        // flags
-        file.write(reinterpret_cast<char*>(&items[i].matched), sizeof(items[i].matched));
-        file.write(reinterpret_cast<char*>(&items[i].claimed), sizeof(items[i].claimed));
-        file.write(reinterpret_cast<char*>(&items[i].matchedItemID), sizeof(items[i].matchedItemID));
+int lowestBit(unsigned long long word) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(word);
+#else
+    int bit = 0;
+    while (!(word & (1ULL << bit))) bit++;
+    return bit;
+#endif
+}
 
-        // person name
-        len = items[i].personName.length();
-        file.write(reinterpret_cast<char*>(&len), sizeof(len));
-        file.write(items[i].personName.c_str(), len);
+void makeDense(BitmapContainer& c) {
+    if (c.dense) return;
+    c.words.assign(BITMAP_WORDS, 0ULL);
+    for (size_t i = 0; i < c.values.size(); i++)
+        c.words[c.values[i] >> 6] |= 1ULL << (c.values[i] & 63);
+    c.values.clear();
+    c.dense = true;
+}
 
-        // person contact
-        len = items[i].personContact.length();
-        file.write(reinterpret_cast<char*>(&len), sizeof(len));
-        file.write(items[i].personContact.c_str(), len);
+void makeSparse(BitmapContainer& c) {
+    if (!c.dense) return;
+    c.values.clear();
+    c.values.reserve(c.cardinality);
+    for (int w = 0; w < BITMAP_WORDS; w++) {
+        unsigned long long word = c.words[w];
+        while (word) {
+            int bit = 0;
+            while (!(word & (1ULL << bit))) bit++;
+            c.values.push_back(static_cast<unsigned short>(w * 64 + bit));
+            word &= word - 1;
+        }
     }
-
-    file.close();
+    c.words.clear();
+    c.dense = false;
 }
 
-void loadFromFile(fstream& file, Item*& items, int& itemCount, int& capacity, int& nextID, const char* filename) {
-    file.open(filename, ios::in | ios::binary);
-    if (!file) {
-        itemCount = 0;
-        nextID = 100;
-        return;
+// Returns the position of the container with the given key, or where it would be inserted
+int findContainer(const Bitmap& bm, unsigned short key) {
+    int lo = 0, hi = static_cast<int>(bm.containers.size());
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (bm.containers[mid].key < key) lo = mid + 1;
+        else hi = mid;
     }
+    return lo;
+}
 
-    // Read header safely
-    if (!file.read(reinterpret_cast<char*>(&nextID), sizeof(nextID)) ||
-        !file.read(reinterpret_cast<char*>(&itemCount), sizeof(itemCount))) {
-        itemCount = 0;
-        nextID = 100;
-        file.close();
-        return;
+void bitmapAdd(Bitmap& bm, int slot) {
+    unsigned short key = static_cast<unsigned short>(slot >> 16);
+    unsigned short low = static_cast<unsigned short>(slot & 0xFFFF);
+
+    int pos = findContainer(bm, key);
+    if (pos == static_cast<int>(bm.containers.size()) || bm.containers[pos].key != key) {
+        BitmapContainer c;
+        c.key = key;
+        c.dense = false;
+        c.cardinality = 0;
+        bm.containers.insert(bm.containers.begin() + pos, c);
     }
 
-    if (itemCount > capacity) {
-        while (capacity < itemCount)
-            capacity *= 2;
-
-        delete[] items;
-        items = new Item[capacity];
+    BitmapContainer& c = bm.containers[pos];
+    if (c.dense) {
+        unsigned long long mask = 1ULL << (low & 63);
+        if (!(c.words[low >> 6] & mask)) {
+            c.words[low >> 6] |= mask;
+            c.cardinality++;
+        }
+        return;
     }
 
-    for (int i = 0; i < itemCount; i++) {
-
-        // id
-        file.read(reinterpret_cast<char*>(&items[i].id), sizeof(items[i].id));
+    vector<unsigned short>::iterator it = lower_bound(c.values.begin(), c.values.end(), low);
+    if (it != c.values.end() && *it == low) return; // already present
+    c.values.insert(it, low);
+    c.cardinality++;
+    if (c.cardinality > BITMAP_ARRAY_LIMIT) makeDense(c);
+}
 
-        size_t len;
-        char* buffer;
+void bitmapRemove(Bitmap& bm, int slot) {
+    unsigned short key = static_cast<unsigned short>(slot >> 16);
+    unsigned short low = static_cast<unsigned short>(slot & 0xFFFF);
 
-        // name
-        file.read(reinterpret_cast<char*>(&len), sizeof(len));
-        buffer = new char[len + 1];
-        file.read(buffer, len);
-        buffer[len] = '\0';
-        items[i].name.assign(buffer, len);
-        delete[] buffer;
+    int pos = findContainer(bm, key);
+    if (pos == static_cast<int>(bm.containers.size()) || bm.containers[pos].key != key)
+        return;
 
-        // category
-        file.read(reinterpret_cast<char*>(&len), sizeof(len));
-        buffer = new char[len + 1];
-        file.read(buffer, len);
-        buffer[len] = '\0';
-        items[i].category.assign(buffer, len);
-        delete[] buffer;
+    BitmapContainer& c = bm.containers[pos];
+    if (c.dense) {
+        unsigned long long mask = 1ULL << (low & 63);
+        if (!(c.words[low >> 6] & mask)) return;
+        c.words[low >> 6] &= ~mask;
+        c.cardinality--;
+        if (c.cardinality <= BITMAP_ARRAY_LIMIT) makeSparse(c);
+    } else {
+        vector<unsigned short>::iterator it = lower_bound(c.values.begin(), c.values.end(), low);
+        if (it == c.values.end() || *it != low) return;
+        c.values.erase(it);
+        c.cardinality--;
+    }
 
-        // description
-        file.read(reinterpret_cast<char*>(&len), sizeof(len));
-        buffer = new char[len + 1];
-        file.read(buffer, len);
-        buffer[len] = '\0';
-        items[i].description.assign(buffer, len);
-        delete[] buffer;
+    if (c.cardinality == 0)
+        bm.containers.erase(bm.containers.begin() + pos);
+}
 
-        // date
-        file.read(items[i].date, sizeof(items[i].date));
+bool bitmapContains(const Bitmap& bm, int slot) {
+    unsigned short key = static_cast<unsigned short>(slot >> 16);
+    unsigned short low = static_cast<unsigned short>(slot & 0xFFFF);
 
-        // location
-        file.read(reinterpret_cast<char*>(&len), sizeof(len));
-        buffer = new char[len + 1];
-        file.read(buffer, len);
-        buffer[len] = '\0';
-        items[i].location.assign(buffer, len);
-        delete[] buffer;
+    int pos = findContainer(bm, key);
+    if (pos == static_cast<int>(bm.containers.size()) || bm.containers[pos].key != key)
+        return false;
 
-        // status
-        file.read(reinterpret_cast<char*>(&len), sizeof(len));
-        buffer = new char[len + 1];
-        file.read(buffer, len);
-        buffer[len] = '\0';
-        items[i].status.assign(buffer, len);
-        delete[] buffer;
+    const BitmapContainer& c = bm.containers[pos];
+    if (c.dense)
+        return (c.words[low >> 6] >> (low & 63)) & 1ULL;
+    return binary_search(c.values.begin(), c.values.end(), low);
+}
 
-        // flags
-        file.read(reinterpret_cast<char*>(&items[i].matched), sizeof(items[i].matched));
-        file.read(reinterpret_cast<char*>(&items[i].claimed), sizeof(items[i].claimed));
-        file.read(reinterpret_cast<char*>(&items[i].matchedItemID), sizeof(items[i].matchedItemID));
+int bitmapCardinality(const Bitmap& bm) {
+    int total = 0;
+    for (size_t i = 0; i < bm.containers.size(); i++)
+        total += bm.containers[i].cardinality;
+    return total;
+}
 
-        // person name
-        file.read(reinterpret_cast<char*>(&len), sizeof(len));
-        buffer = new char[len + 1];
-        file.read(buffer, len);
-        buffer[len] = '\0';
-        items[i].personName.assign(buffer, len);
-        delete[] buffer;
+BitmapContainer andContainers(const BitmapContainer& a, const BitmapContainer& b) {
+    BitmapContainer out;
+    out.key = a.key;
+    out.dense = false;
+    out.cardinality = 0;
+
+    if (a.dense && b.dense) {
+        // Word-wide AND over both bitsets
+        out.dense = true;
+        out.words.resize(BITMAP_WORDS);
+        for (int w = 0; w < BITMAP_WORDS; w++) {
+            out.words[w] = a.words[w] & b.words[w];
+            out.cardinality += countBits(out.words[w]);
+        }
+        if (out.cardinality <= BITMAP_ARRAY_LIMIT) makeSparse(out);
+    } else if (a.dense || b.dense) {
+        const BitmapContainer& sparse = a.dense ? b : a;
+        const BitmapContainer& dense = a.dense ? a : b;
+        for (size_t i = 0; i < sparse.values.size(); i++) {
+            unsigned short v = sparse.values[i];
+            if ((dense.words[v >> 6] >> (v & 63)) & 1ULL)
+                out.values.push_back(v);
+        }
+        out.cardinality = static_cast<int>(out.values.size());
+    } else {
+        set_intersection(a.values.begin(), a.values.end(),
+                         b.values.begin(), b.values.end(),
+                         back_inserter(out.values));
+        out.cardinality = static_cast<int>(out.values.size());
+    }
+    return out;
+}
 
-        // person contact
-        file.read(reinterpret_cast<char*>(&len), sizeof(len));
-        buffer = new char[len + 1];
-        file.read(buffer, len);
-        buffer[len] = '\0';
-        items[i].personContact.assign(buffer, len);
-        delete[] buffer;
+BitmapContainer orContainers(const BitmapContainer& a, const BitmapContainer& b) {
+    BitmapContainer out;
+    out.key = a.key;
+    out.dense = false;
+    out.cardinality = 0;
+
+    if (!a.dense && !b.dense && a.cardinality + b.cardinality <= BITMAP_ARRAY_LIMIT) {
+        set_union(a.values.begin(), a.values.end(),
+                  b.values.begin(), b.values.end(),
+                  back_inserter(out.values));
+        out.cardinality = static_cast<int>(out.values.size());
+        return out;
     }
 
-    file.close();
+    BitmapContainer left = a, right = b;
+    makeDense(left);
+    makeDense(right);
+    out.dense = true;
+    out.words.resize(BITMAP_WORDS);
+    for (int w = 0; w < BITMAP_WORDS; w++) {
+        out.words[w] = left.words[w] | right.words[w];
+        out.cardinality += countBits(out.words[w]);
+    }
+    if (out.cardinality <= BITMAP_ARRAY_LIMIT) makeSparse(out);
+    return out;
 }
 
+Bitmap bitmapAnd(const Bitmap& a, const Bitmap& b) {
+    Bitmap out;
+    size_t i = 0, j = 0;
+    while (i < a.containers.size() && j < b.containers.size()) {
+        if (a.containers[i].key < b.containers[j].key) i++;
+        else if (a.containers[i].key > b.containers[j].key) j++;
+        else {
+            BitmapContainer c = andContainers(a.containers[i], b.containers[j]);
+            if (c.cardinality > 0) out.containers.push_back(c);
+            i++;
+            j++;
+        }
+    }
+    return out;
+}
 
-void viewFromFile(const char* filename, fstream& file) {
-    int itemCount = 0;
-    int capacity = 10;  // initial capacity
-    int nextID = 100;
-
-    Item* items = new Item[capacity];
+Bitmap bitmapOr(const Bitmap& a, const Bitmap& b) {
+    Bitmap out;
+    size_t i = 0, j = 0;
+    while (i < a.containers.size() || j < b.containers.size()) {
+        if (j == b.containers.size() ||
+            (i < a.containers.size() && a.containers[i].key < b.containers[j].key)) {
+            out.containers.push_back(a.containers[i++]);
+        } else if (i == a.containers.size() || a.containers[i].key > b.containers[j].key) {
+            out.containers.push_back(b.containers[j++]);
+        } else {
+            out.containers.push_back(orContainers(a.containers[i], b.containers[j]));
+            i++;
+            j++;
+        }
+    }
+    return out;
+}
 
-    loadFromFile(file, items, itemCount, capacity, nextID, filename);
+bool lowerContainerKey(const BitmapContainer* a, const BitmapContainer* b) {
+    return a->key < b->key;
+}
 
-    if (itemCount == 0) {
-        cout << "\nNo items to display.\n";
-        delete[] items;
-        return;
+// Union of many bitmaps in one pass: the containers sharing a key are ORed into
+// one scratch bitset and the output container is built from it once, instead
+// of re-copying a growing result as chained bitmapOr calls would
+Bitmap bitmapOrMany(const vector<const Bitmap*>& parts) {
+    vector<const BitmapContainer*> all;
+    for (size_t p = 0; p < parts.size(); p++) {
+        for (size_t i = 0; i < parts[p]->containers.size(); i++) all.push_back(&parts[p]->containers[i]);
     }
+    sort(all.begin(), all.end(), lowerContainerKey);
+
+    Bitmap out;
+    vector<unsigned long long> words;
+    for (size_t i = 0; i < all.size();) {
+        size_t end = i + 1;
+        while (end < all.size() && all[end]->key == all[i]->key) end++;
+        if (end - i == 1) {
+            out.containers.push_back(*all[i++]);
+            continue;
+        }
 
-cout << "\n===========================================================================================================================\n";
-cout << "\n====================    ITEMS ON RECORD    ================================================================================\n";
+        words.assign(BITMAP_WORDS, 0ULL);
+        for (size_t j = i; j < end; j++) {
+            const BitmapContainer& in = *all[j];
+            if (in.dense) {
+                for (int w = 0; w < BITMAP_WORDS; w++) words[w] |= in.words[w];
+            } else {
+                for (size_t v = 0; v < in.values.size(); v++) words[in.values[v] >> 6] |= 1ULL << (in.values[v] & 63);
+            }
+        }
 
-    for (int i = 0; i < itemCount; i++) {
-        cout << "Item " << i + 1 << ":\n";
-        displayItem(items[i]);
-        
+        BitmapContainer c;
+        c.key = all[i]->key;
+        c.cardinality = 0;
+        for (int w = 0; w < BITMAP_WORDS; w++) c.cardinality += countBits(words[w]);
+        c.dense = c.cardinality > BITMAP_ARRAY_LIMIT;
+        if (c.dense) {
+            c.words.swap(words);
+        } else {
+            c.values.reserve(c.cardinality);
+            for (int w = 0; w < BITMAP_WORDS; w++) {
+                for (unsigned long long word = words[w]; word; word &= word - 1)
+                    c.values.push_back(static_cast<unsigned short>(w * 64 + lowestBit(word)));
+            }
+        }
+        out.containers.push_back(c);
+        i = end;
     }
+    return out;
+}
 
-    delete[] items;
+// Union of a range of buckets (dates, Euler-tour positions)
+Bitmap bucketUnion(map<int, Bitmap>::const_iterator from, map<int, Bitmap>::const_iterator to) {
+    vector<const Bitmap*> parts;
+    for (; from != to; ++from) parts.push_back(&from->second);
+    return bitmapOrMany(parts);
 }
 
-void clearAllItems(Item items[], int& itemCount, int& nextID, const char* filename) {
-    string confirm;
-
-    while (true) {
-        cout << "Are you sure you want to delete ALL items? (Y/N): ";
-        getline(cin, confirm);
-
-        if (confirm == "Y" || confirm == "y") {
-            ofstream out(filename, ios::binary | ios::trunc);
-            if (!out) {
-                cout << "Error clearing file!\n";
-                return;
+// Size of a AND b without building the intersection (used for facet counts)
+int bitmapAndCardinality(const Bitmap& a, const Bitmap& b) {
+    int total = 0;
+    size_t i = 0, j = 0;
+    while (i < a.containers.size() && j < b.containers.size()) {
+        const BitmapContainer& x = a.containers[i];
+        const BitmapContainer& y = b.containers[j];
+        if (x.key < y.key) { i++; continue; }
+        if (x.key > y.key) { j++; continue; }
+
+        if (x.dense && y.dense) {
+            for (int w = 0; w < BITMAP_WORDS; w++)
+                total += countBits(x.words[w] & y.words[w]);
+        } else if (x.dense || y.dense) {
+            const BitmapContainer& sparse = x.dense ? y : x;
+            const BitmapContainer& dense = x.dense ? x : y;
+            for (size_t v = 0; v < sparse.values.size(); v++)
+                total += static_cast<int>((dense.words[sparse.values[v] >> 6] >> (sparse.values[v] & 63)) & 1ULL);
+        } else {
+            size_t p = 0, q = 0;
+            while (p < x.values.size() && q < y.values.size()) {
+                if (x.values[p] < y.values[q]) p++;
+                else if (x.values[p] > y.values[q]) q++;
+                else { total++; p++; q++; }
             }
-            out.close();
-
-            itemCount = 0;
-            nextID = 100;
-            cout << "All items cleared successfully.\n";
-            return;
         }
-        else if (confirm == "N" || confirm == "n") {
-            cout << "Operation cancelled. No items were deleted.\n";
-            return;
+        i++;
+        j++;
+    }
+    return total;
+}
+
+// Smallest slot >= from, or -1 when there is none
+int bitmapNextSlot(const Bitmap& bm, int from) {
+    if (from < 0) from = 0;
+    for (int pos = findContainer(bm, static_cast<unsigned short>(from >> 16)); pos < static_cast<int>(bm.containers.size()); pos++) {
+        const BitmapContainer& c = bm.containers[pos];
+        int base = c.key << 16;
+        int low = from > base ? from - base : 0;
+        if (low > 0xFFFF) continue;
+
+        if (c.dense) {
+            int w = low >> 6;
+            unsigned long long word = c.words[w] & (~0ULL << (low & 63));
+            while (true) {
+                if (word) return base + w * 64 + lowestBit(word);
+                if (++w == BITMAP_WORDS) break;
+                word = c.words[w];
+            }
+        } else {
+            vector<unsigned short>::const_iterator it =
+                lower_bound(c.values.begin(), c.values.end(), static_cast<unsigned short>(low));
+            if (it != c.values.end()) return base + *it;
         }
-        else {
-            cout << "Invalid input. Please enter only Y or N.\n";
+    }
+    return -1;
+}
+
+// Writes every slot in ascending order into results, returns how many were written
+int bitmapToArray(const Bitmap& bm, int results[]) {
+    int count = 0;
+    for (size_t i = 0; i < bm.containers.size(); i++) {
+        const BitmapContainer& c = bm.containers[i];
+        int base = c.key << 16;
+        if (c.dense) {
+            for (int w = 0; w < BITMAP_WORDS; w++) {
+                unsigned long long word = c.words[w];
+                while (word) {
+                    int bit = 0;
+                    while (!(word & (1ULL << bit))) bit++;
+                    results[count++] = base + w * 64 + bit;
+                    word &= word - 1;
+                }
+            }
+        } else {
+            for (size_t v = 0; v < c.values.size(); v++)
+                results[count++] = base + c.values[v];
         }
     }
+    return count;
 }
 
 
@@ -523,258 +844,4035 @@ void clearAllItems(Item items[], int& itemCount, int& nextID, const char* filena
 
 
 
+// Value Dictionaries
+// Distinct values of a text field with how often each occurs, sorted by lower-case key.
+// Serves prefix suggestions with a binary search.
+struct DictionaryEntry {
+    string key;        // lower-case value
+    string display;    // spelling as first entered
+    int count;
+};
+
+struct ValueDictionary {
+    vector<DictionaryEntry> entries;
+};
 
+int findDictionaryEntry(const ValueDictionary& dict, const string& key) {
+    int lo = 0, hi = static_cast<int>(dict.entries.size());
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (dict.entries[mid].key < key) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
 
+void dictionaryAdd(ValueDictionary& dict, const string& value) {
+    string key = toLowerCase(value);
+    int pos = findDictionaryEntry(dict, key);
+    if (pos < static_cast<int>(dict.entries.size()) && dict.entries[pos].key == key) {
+        dict.entries[pos].count++;
+        return;
+    }
 
+    DictionaryEntry entry;
+    entry.key = key;
+    entry.display = value;
+    entry.count = 1;
+    dict.entries.insert(dict.entries.begin() + pos, entry);
+}
 
-//Search & Filter Functions
+void dictionaryRemove(ValueDictionary& dict, const string& value) {
+    string key = toLowerCase(value);
+    int pos = findDictionaryEntry(dict, key);
+    if (pos == static_cast<int>(dict.entries.size()) || dict.entries[pos].key != key) return;
 
-int searchByName(Item items[], int itemCount, const string& name, int results[]) {
-    int count = 0;
-    for (int i = 0; i < itemCount; i++) {
-        if (containsSubstring(items[i].name, name)) {
-            results[count++] = i;
+    if (--dict.entries[pos].count == 0)
+        dict.entries.erase(dict.entries.begin() + pos);
+}
+
+// Up to limit values starting with prefix, most frequent first
+vector<DictionaryEntry> dictionarySuggest(const ValueDictionary& dict, const string& prefix, int limit) {
+    string key = toLowerCase(prefix);
+    vector<DictionaryEntry> found;
+    for (size_t i = findDictionaryEntry(dict, key); i < dict.entries.size(); i++) {
+        if (dict.entries[i].key.compare(0, key.size(), key) != 0) break;
+        found.push_back(dict.entries[i]);
+    }
+
+    // Insertion sort by count keeps alphabetical order among equal counts
+    for (size_t i = 1; i < found.size(); i++) {
+        DictionaryEntry entry = found[i];
+        size_t j = i;
+        while (j > 0 && found[j - 1].count < entry.count) {
+            found[j] = found[j - 1];
+            j--;
         }
+        found[j] = entry;
     }
-    return count;
+    if (found.size() > static_cast<size_t>(limit)) found.resize(limit);
+    return found;
 }
 
-int searchByCategory(Item items[], int itemCount, const string& category, int results[]) {
-    int count = 0;
-    for (int i = 0; i < itemCount; i++) {
-        if (containsSubstring(items[i].category, category)) {
-            results[count++] = i;
+
+
+
+
+
+
+// Location Hierarchy
+// Optional tree of places read from locations.txt, one path per line from the
+// site down, e.g.  Main Campus > Library > Floor 2|2nd floor > Reading Room
+// ("|" adds other names for the same place). A free-text item location is
+// resolved to the deepest node its parts lead to. Nodes are numbered in DFS
+// order so a subtree is one range of numbers, and an Euler tour with a sparse
+// table of depth minima answers lowest-common-ancestor queries in O(1).
+
+struct LocationNode {
+    string name;           // as first written
+    int parent;            // -1 for the root
+    int depth;             // 0 for the root above all sites
+    vector<int> children;
+    int enter, exit;       // DFS numbers; the subtree of a node is [enter, exit]
+    int firstVisit;        // first position in the Euler tour
+};
+
+struct LocationTree {
+    vector<LocationNode> nodes;                  // nodes[0] is the root
+    unordered_map<string, vector<int> > byName;  // locationKey of a name or alias -> nodes
+    vector<int> tour;                            // Euler tour, nodes as visited
+    vector<vector<int> > shallowest;             // shallowest[j][i]: least deep node in tour[i, i + 2^j)
+
+    LocationTree() {
+        LocationNode root;
+        root.name = "";
+        root.parent = -1;
+        root.depth = 0;
+        root.enter = root.exit = root.firstVisit = 0;
+        nodes.push_back(root);
+    }
+};
+
+// Lower-case words joined by single spaces: "Reading-Room " -> "reading room"
+string locationKey(const string& text) {
+    string key;
+    for (size_t i = 0; i < text.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (isalnum(c)) {
+            if (!key.empty() && !isalnum(static_cast<unsigned char>(text[i - 1]))) key += ' ';
+            key += static_cast<char>(tolower(c));
         }
     }
-    return count;
+    return key;
 }
 
-int searchByDescription(Item items[], int itemCount, const string& description, int results[]) {
-    int count = 0;
-    for (int i = 0; i < itemCount; i++) {
-        if (containsSubstring(items[i].description, description)) {
-            results[count++] = i;
+int childNamed(const LocationTree& tree, int parent, const string& key) {
+    unordered_map<string, vector<int> >::const_iterator it = tree.byName.find(key);
+    if (it == tree.byName.end()) return -1;
+    for (size_t i = 0; i < it->second.size(); i++) {
+        if (tree.nodes[it->second[i]].parent == parent) return it->second[i];
+    }
+    return -1;
+}
+
+// Adds one "site > building > ..." path, reusing the nodes that exist
+void addLocationPath(LocationTree& tree, const string& line) {
+    int node = 0;
+    size_t pos = 0;
+    while (pos <= line.size()) {
+        size_t end = line.find('>', pos);
+        if (end == string::npos) end = line.size();
+        string part = line.substr(pos, end - pos);
+        pos = end + 1;
+
+        vector<string> names;
+        size_t from = 0;
+        while (from <= part.size()) {
+            size_t bar = part.find('|', from);
+            if (bar == string::npos) bar = part.size();
+            string name = part.substr(from, bar - from);
+            if (!locationKey(name).empty()) names.push_back(name);
+            from = bar + 1;
         }
+        if (names.empty()) continue;
+
+        int child = -1;
+        for (size_t i = 0; i < names.size() && child == -1; i++) child = childNamed(tree, node, locationKey(names[i]));
+        if (child == -1) {
+            LocationNode entry;
+            size_t first = names[0].find_first_not_of(' ');
+            entry.name = names[0].substr(first, names[0].find_last_not_of(' ') - first + 1);
+            entry.parent = node;
+            entry.depth = tree.nodes[node].depth + 1;
+            entry.enter = entry.exit = entry.firstVisit = 0;
+            child = static_cast<int>(tree.nodes.size());
+            tree.nodes.push_back(entry);
+            tree.nodes[node].children.push_back(child);
+        }
+        for (size_t i = 0; i < names.size(); i++) {
+            vector<int>& named = tree.byName[locationKey(names[i])];
+            if (find(named.begin(), named.end(), child) == named.end()) named.push_back(child);
+        }
+        node = child;
     }
-    return count;
 }
 
-int searchByLocation(Item items[], int itemCount, const string& location, int results[]) {
-    int count = 0;
-    for (int i = 0; i < itemCount; i++) {
-        if (containsSubstring(items[i].location, location)) {
-            results[count++] = i;
+int shallowerNode(const LocationTree& tree, int a, int b) {
+    return tree.nodes[a].depth <= tree.nodes[b].depth ? a : b;
+}
+
+// DFS numbering, Euler tour and sparse table; call after the last addLocationPath
+void buildLocationTree(LocationTree& tree) {
+    tree.tour.clear();
+    int counter = 0;
+    vector<pair<int, size_t> > stack(1, make_pair(0, static_cast<size_t>(0)));
+    tree.nodes[0].enter = counter++;
+    tree.nodes[0].firstVisit = 0;
+    tree.tour.push_back(0);
+    while (!stack.empty()) {
+        int node = stack.back().first;
+        size_t next = stack.back().second++;
+        if (next < tree.nodes[node].children.size()) {
+            int child = tree.nodes[node].children[next];
+            tree.nodes[child].enter = counter++;
+            tree.nodes[child].firstVisit = static_cast<int>(tree.tour.size());
+            tree.tour.push_back(child);
+            stack.push_back(make_pair(child, static_cast<size_t>(0)));
+        } else {
+            tree.nodes[node].exit = counter - 1;
+            stack.pop_back();
+            if (!stack.empty()) tree.tour.push_back(stack.back().first);
         }
     }
-    return count;
+
+    tree.shallowest.assign(1, tree.tour);
+    for (size_t width = 2; width <= tree.tour.size(); width *= 2) {
+        const vector<int>& prev = tree.shallowest.back();
+        vector<int> level(tree.tour.size() - width + 1);
+        for (size_t i = 0; i < level.size(); i++)
+            level[i] = shallowerNode(tree, prev[i], prev[i + width / 2]);
+        tree.shallowest.push_back(level);
+    }
 }
 
+int lowestCommonAncestor(const LocationTree& tree, int a, int b) {
+    int from = tree.nodes[a].firstVisit, to = tree.nodes[b].firstVisit;
+    if (from > to) swap(from, to);
+    int level = 0;
+    while ((2 << level) <= to - from + 1) level++;
+    return shallowerNode(tree, tree.shallowest[level][from], tree.shallowest[level][to - (1 << level) + 1]);
+}
 
-int searchByDate(Item items[], int itemCount, const char* date, int results[]) {
-    int count = 0;
+// Wu-Palmer similarity: 1 for the same place, 2/3 for a library and a room two
+// levels inside it, 0 for different sites
+double locationProximity(const LocationTree& tree, int a, int b) {
+    int common = lowestCommonAncestor(tree, a, b);
+    return 2.0 * tree.nodes[common].depth / (tree.nodes[a].depth + tree.nodes[b].depth);
+}
 
-    for (int i = 0; i < itemCount; i++) {
-        if (strcmp(items[i].date, date) == 0) {
-            results[count++] = i;
+// Deepest node that the comma- or ">"-separated parts of text lead to, -1 if none.
+// The first recognized part may be any node; each later one must lie below it.
+int resolveLocation(const LocationTree& tree, const string& text) {
+    int node = -1;
+    size_t pos = 0;
+    while (pos <= text.size()) {
+        size_t end = text.find_first_of(",>", pos);
+        if (end == string::npos) end = text.size();
+        string key = locationKey(text.substr(pos, end - pos));
+        pos = end + 1;
+        if (key.empty()) continue;
+
+        unordered_map<string, vector<int> >::const_iterator it = tree.byName.find(key);
+        if (it == tree.byName.end()) continue;
+        int best = -1;
+        for (size_t i = 0; i < it->second.size(); i++) {
+            int candidate = it->second[i];
+            bool below = node == -1 || (tree.nodes[candidate].enter > tree.nodes[node].enter &&
+                                        tree.nodes[candidate].enter <= tree.nodes[node].exit);
+            if (below && (best == -1 || tree.nodes[candidate].depth < tree.nodes[best].depth)) best = candidate;
         }
+        if (best != -1) node = best;
     }
+    return node;
+}
 
-    return count; // number of matches
+void loadLocations(LocationTree& tree, const char* filename) {
+    tree = LocationTree();
+    ifstream in(filename);
+    string line;
+    while (in && getline(in, line)) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == string::npos || line[first] == '#') continue;
+        addLocationPath(tree, line);
+    }
+    buildLocationTree(tree);
 }
 
-int searchByStatus(Item items[], int itemCount, const string& status, int results[]) {
-    int count = 0;
-    string lowerStatus = toLowerCase(status);
 
-    for (int i = 0; i < itemCount; i++) {
-        string itemStatus = toLowerCase(items[i].status);
 
-        // Check if status matches AND item is unmatched
-        if (itemStatus == lowerStatus && items[i].matched == 0) {
-            results[count++] = i;
+
+
+
+
+
+// Spatial Grid
+// Geo-tagged items on a uniform grid of GEO_CELL_DEGREES squares, so "found
+// within 200 m" and "the 5 nearest" only look at the cells around a point.
+// Each cell keeps its points' coordinates next to the slot, so a query never
+// touches the items array.
+
+const double GEO_CELL_DEGREES = 0.002;    // about 220 m north-south
+const double EARTH_RADIUS_M = 6371000.0;
+const double METERS_PER_DEGREE = EARTH_RADIUS_M * 3.14159265358979323846 / 180.0;
+const double GEO_MAX_RADIUS_M = 50000.0;  // largest radius the filter menu accepts
+
+// Great-circle distance (haversine)
+double geoDistanceMeters(double lat1, double lon1, double lat2, double lon2) {
+    const double rad = 3.14159265358979323846 / 180.0;
+    double dLat = (lat2 - lat1) * rad, dLon = (lon2 - lon1) * rad;
+    double h = sin(dLat / 2) * sin(dLat / 2) + cos(lat1 * rad) * cos(lat2 * rad) * sin(dLon / 2) * sin(dLon / 2);
+    return 2.0 * EARTH_RADIUS_M * asin(min(1.0, sqrt(h)));
+}
+
+struct GeoPoint {
+    int slot;
+    double latitude, longitude;
+};
+
+struct GeoGrid {
+    unordered_map<long long, vector<GeoPoint> > cells;   // geoCellKey -> points
+    int minRow, maxRow, minCol, maxCol;                  // cells ever used, bounds the kNN search
+    int count;
+
+    GeoGrid() : minRow(INT_MAX), maxRow(INT_MIN), minCol(INT_MAX), maxCol(INT_MIN), count(0) {}
+};
+
+int geoRow(double latitude) { return static_cast<int>(floor(latitude / GEO_CELL_DEGREES)); }
+int geoCol(double longitude) { return static_cast<int>(floor(longitude / GEO_CELL_DEGREES)); }
+
+long long geoCellKey(int row, int col) {
+    return (static_cast<long long>(row) << 32) | static_cast<unsigned int>(col);
+}
+
+void gridAdd(GeoGrid& grid, int slot, double latitude, double longitude) {
+    int row = geoRow(latitude), col = geoCol(longitude);
+    GeoPoint point;
+    point.slot = slot;
+    point.latitude = latitude;
+    point.longitude = longitude;
+    grid.cells[geoCellKey(row, col)].push_back(point);
+    grid.minRow = min(grid.minRow, row);
+    grid.maxRow = max(grid.maxRow, row);
+    grid.minCol = min(grid.minCol, col);
+    grid.maxCol = max(grid.maxCol, col);
+    grid.count++;
+}
+
+void gridRemove(GeoGrid& grid, int slot, double latitude, double longitude) {
+    unordered_map<long long, vector<GeoPoint> >::iterator cell = grid.cells.find(geoCellKey(geoRow(latitude), geoCol(longitude)));
+    if (cell == grid.cells.end()) return;
+    vector<GeoPoint>& points = cell->second;
+    for (size_t i = 0; i < points.size(); i++) {
+        if (points[i].slot != slot) continue;
+        points[i] = points.back();
+        points.pop_back();
+        grid.count--;
+        break;
+    }
+    if (points.empty()) grid.cells.erase(cell);
+}
+
+bool nearerPoint(const pair<double, int>& a, const pair<double, int>& b) {
+    return a.first != b.first ? a.first < b.first : a.second < b.second;
+}
+
+// Every point within radius meters, nearest first, as (meters, slot)
+vector<pair<double, int> > gridWithin(const GeoGrid& grid, double latitude, double longitude, double radius) {
+    vector<pair<double, int> > found;
+    if (grid.count == 0 || radius < 0) return found;
+    double latSpan = radius / METERS_PER_DEGREE;
+    double widest = min(89.9, fabs(latitude) + latSpan); // cells are narrowest toward the pole
+    double lonSpan = min(180.0, latSpan / cos(widest * 3.14159265358979323846 / 180.0));
+
+    // Only cells inside the bounding box of used cells can hold points
+    int firstRow = max(grid.minRow, geoRow(latitude - latSpan)), lastRow = min(grid.maxRow, geoRow(latitude + latSpan));
+    int firstCol = max(grid.minCol, geoCol(longitude - lonSpan)), lastCol = min(grid.maxCol, geoCol(longitude + lonSpan));
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int col = firstCol; col <= lastCol; col++) {
+            unordered_map<long long, vector<GeoPoint> >::const_iterator cell = grid.cells.find(geoCellKey(row, col));
+            if (cell == grid.cells.end()) continue;
+            for (size_t i = 0; i < cell->second.size(); i++) {
+                const GeoPoint& p = cell->second[i];
+                double d = geoDistanceMeters(latitude, longitude, p.latitude, p.longitude);
+                if (d <= radius) found.push_back(make_pair(d, p.slot));
+            }
         }
     }
+    sort(found.begin(), found.end(), nearerPoint);
+    return found;
+}
 
-    return count;
+// Offers one cell's points to the best-k max-heap used by gridNearest
+void nearestInCell(const GeoGrid& grid, int row, int col, double latitude, double longitude, int k,
+                   vector<pair<double, int> >& heap) {
+    unordered_map<long long, vector<GeoPoint> >::const_iterator cell = grid.cells.find(geoCellKey(row, col));
+    if (cell == grid.cells.end()) return;
+    for (size_t i = 0; i < cell->second.size(); i++) {
+        const GeoPoint& p = cell->second[i];
+        pair<double, int> hit(geoDistanceMeters(latitude, longitude, p.latitude, p.longitude), p.slot);
+        if (static_cast<int>(heap.size()) < k) {
+            heap.push_back(hit);
+            push_heap(heap.begin(), heap.end(), nearerPoint);
+        } else if (nearerPoint(hit, heap.front())) {
+            pop_heap(heap.begin(), heap.end(), nearerPoint);
+            heap.back() = hit;
+            push_heap(heap.begin(), heap.end(), nearerPoint);
+        }
+    }
 }
 
-int filterByMatched(Item items[], int itemCount, int matchedValue, int results[]) {
-    int count = 0;
-    for (int i = 0; i < itemCount; i++) {
-        if (items[i].matched == matchedValue) {
-            results[count++] = i;
+// The k nearest points, nearest first. Rings of cells are added around the
+// point until the k-th distance is inside the area the rings fully cover.
+// Rings start at the first one that reaches the bounding box of used cells
+// and are clipped to it, so a point far from every item costs no more than
+// one next to them.
+vector<pair<double, int> > gridNearest(const GeoGrid& grid, double latitude, double longitude, int k) {
+    vector<pair<double, int> > heap;   // max-heap on distance of the best k so far
+    if (k <= 0 || grid.count == 0) return heap;
+    int row0 = geoRow(latitude), col0 = geoCol(longitude);
+    int firstRing = max(max(max(grid.minRow - row0, row0 - grid.maxRow), max(grid.minCol - col0, col0 - grid.maxCol)), 0);
+    int lastRing = max(max(abs(grid.minRow - row0), abs(grid.maxRow - row0)),
+                       max(abs(grid.minCol - col0), abs(grid.maxCol - col0)));
+
+    for (int ring = firstRing; ring <= lastRing; ring++) {
+        int firstRow = max(grid.minRow, row0 - ring), lastRow = min(grid.maxRow, row0 + ring);
+        int firstCol = max(grid.minCol, col0 - ring), lastCol = min(grid.maxCol, col0 + ring);
+        for (int row = firstRow; row <= lastRow; row++) {
+            if (row == row0 - ring || row == row0 + ring) {
+                for (int col = firstCol; col <= lastCol; col++) nearestInCell(grid, row, col, latitude, longitude, k, heap);
+                continue;
+            }
+            if (col0 - ring >= grid.minCol) nearestInCell(grid, row, col0 - ring, latitude, longitude, k, heap);
+            if (col0 + ring <= grid.maxCol) nearestInCell(grid, row, col0 + ring, latitude, longitude, k, heap);
         }
+
+        // Distance from the point to the nearest edge of the rings searched so far
+        double top = (row0 + ring + 1) * GEO_CELL_DEGREES, bottom = (row0 - ring) * GEO_CELL_DEGREES;
+        double right = (col0 + ring + 1) * GEO_CELL_DEGREES, left = (col0 - ring) * GEO_CELL_DEGREES;
+        double narrowest = cos(min(89.9, max(fabs(top), fabs(bottom))) * 3.14159265358979323846 / 180.0);
+        double covered = min(min(top - latitude, latitude - bottom) * METERS_PER_DEGREE,
+                             min(right - longitude, longitude - left) * METERS_PER_DEGREE * narrowest);
+        if (static_cast<int>(heap.size()) == k && heap.front().first <= covered) break;
     }
-    return count;
+    sort_heap(heap.begin(), heap.end(), nearerPoint);
+    return heap;
 }
 
-int filterByClaimed(Item items[], int itemCount, int claimedValue, int results[]) {
-    int count = 0;
-    for (int i = 0; i < itemCount; i++) {
-        if (items[i].claimed == claimedValue) {
-            results[count++] = i;
+
+
+
+
+
+
+
+// Item Indexes
+// Bitmaps over array slots, kept in sync with every mutation of the items array.
+
+// Lower-case runs of letters and digits, in order; "Black-leather bag" -> black, leather, bag
+vector<string> tokensOf(const string& text) {
+    vector<string> tokens;
+    string token;
+    for (size_t i = 0; i <= text.size(); i++) {
+        unsigned char c = i < text.size() ? static_cast<unsigned char>(text[i]) : ' ';
+        if (isalnum(c)) {
+            token += static_cast<char>(tolower(c));
+        } else if (!token.empty()) {
+            tokens.push_back(token);
+            token.clear();
         }
     }
-    return count;
+    return tokens;
 }
 
-void filterSearchMenu(Item items[], int itemCount) {
-    int choice;
-    string input;
+// Text normalization: tokens are stemmed and mapped through a synonym table,
+// then interned, so "Phones", "mobile" and "cellphone" all become the term
+// "phone" and are compared as one integer. The table has built-in entries and
+// can be extended from synonyms.txt ("canonical = word, word, ...").
+struct TextNormalizer {
+    unordered_map<string, string> synonyms;   // stemmed word -> stemmed canonical word
+    unordered_map<string, int> termIDs;       // normalized term -> ID
+    vector<string> terms;                     // ID -> normalized term
+};
 
-    int* results = new int[itemCount]; // dynamic array for search results
+bool endsWith(const string& w, const char* suffix) {
+    size_t n = strlen(suffix);
+    return w.size() >= n && w.compare(w.size() - n, n, suffix) == 0;
+}
 
-    do {
-        cout << "\n--- Filter / Search Items ---\n";
-        cout << "1. By Name\n2. By Category\n3. By Description\n4. By Location\n";
-        cout << "5. By Status\n6. By Matched / Unmatched\n7. By Claimed / Unclaimed\n";
-        cout << "8. By Date\n"; 
-        cout << "9. Back to Main Menu\n"; 
-        cout << "Select an option: ";
+// A final s that marks a plural rather than "glass", "bus", "iris" or "lens"
+bool pluralS(const string& w) {
+    return w.size() > 3 && endsWith(w, "s") && !endsWith(w, "ss") && !endsWith(w, "us") && !endsWith(w, "is") && !endsWith(w, "ns");
+}
 
-        if (!(cin >> choice)) {
-            cout << "Invalid input! Please enter a number.\n";
-            cin.clear();
-            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+// One pass of stemWord: the plural first, then -ing/-ed, then a final e
+string stemOnce(const string& word) {
+    string w = word;
+    if (w.size() <= 3 || !isalpha(static_cast<unsigned char>(w[w.size() - 1]))) return w;
+
+    if (w.size() > 4 && endsWith(w, "ies")) w = w.substr(0, w.size() - 3) + "y";
+    else if (endsWith(w, "sses") || endsWith(w, "ches") || endsWith(w, "shes") || endsWith(w, "xes")) w.erase(w.size() - 2);
+    else if (pluralS(w)) w.erase(w.size() - 1);
+
+    size_t cut = endsWith(w, "ing") ? 3 : endsWith(w, "ed") ? 2 : 0;
+    if (cut > 0 && w.size() - cut > 3) {                           // "ring", "speed"
+        string stem = w.substr(0, w.size() - cut);
+        size_t m = stem.size();
+        bool doubled = stem[m - 1] == stem[m - 2] && strchr("aeiou", stem[m - 1]) == NULL; // "earring", "missing"
+        if (stem.find_first_of("aeiouy") != string::npos && !doubled)                      // "string"
+            w = pluralS(stem) ? stem + "e" : stem;                 // closed -> close, not clos
+    }
+
+    // phone/phones, engrave/engraved meet without it; "purse" keeps it
+    if (w.size() > 4 && endsWith(w, "e") && !pluralS(w.substr(0, w.size() - 1))) w.erase(w.size() - 1);
+    return w;
+}
+
+// Light suffix stripping, enough to make singular, plural, -ing and -ed forms meet:
+// keys -> key, watches -> watch, batteries -> battery, buildings/building -> build,
+// lenses/lens -> lens. Repeated until nothing changes, so stemWord(stemWord(w)) == stemWord(w).
+string stemWord(const string& word) {
+    string w = word, next = stemOnce(word);
+    while (next != w) {
+        w = next;
+        next = stemOnce(w);
+    }
+    return w;
+}
+
+string normalizeWord(const TextNormalizer& norm, const string& token) {
+    string stem = stemWord(token);
+    unordered_map<string, string>::const_iterator it = norm.synonyms.find(stem);
+    return it == norm.synonyms.end() ? stem : it->second;
+}
+
+void addSynonyms(TextNormalizer& norm, const string& canonical, const string& words) {
+    string target = normalizeWord(norm, canonical);
+    vector<string> list = tokensOf(words);
+    for (size_t i = 0; i < list.size(); i++)
+        norm.synonyms[stemWord(list[i])] = target;
+}
+
+void defaultSynonyms(TextNormalizer& norm) {
+    norm.synonyms.clear();
+    addSynonyms(norm, "phone", "mobile cellphone smartphone iphone cell");
+    addSynonyms(norm, "bag", "backpack rucksack handbag satchel tote knapsack");
+    addSynonyms(norm, "wallet", "purse billfold");
+    addSynonyms(norm, "headphone", "earphone earbud headset airpod");
+    addSynonyms(norm, "glass", "spectacle eyeglass");
+    addSynonyms(norm, "jacket", "coat");
+    addSynonyms(norm, "key", "keyring keychain");
+    addSynonyms(norm, "laptop", "notebook macbook chromebook");
+    addSynonyms(norm, "bottle", "flask");
+    addSynonyms(norm, "umbrella", "brolly");
+}
+
+// Adds the entries of the file to the built-in table
+void loadSynonyms(TextNormalizer& norm, const char* filename) {
+    defaultSynonyms(norm);
+    ifstream in(filename);
+    if (!in) return;
+
+    string line;
+    while (getline(in, line)) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == string::npos || line[first] == '#') continue;
+        size_t eq = line.find('=');
+        vector<string> canonical = tokensOf(line.substr(0, eq));
+        if (eq == string::npos || canonical.size() != 1 || tokensOf(line.substr(eq + 1)).empty()) {
+            cout << filename << ": ignoring '" << line << "'\n";
             continue;
         }
-        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        addSynonyms(norm, canonical[0], line.substr(eq + 1));
+    }
+}
 
-        int count = 0;
+int internTerm(TextNormalizer& norm, const string& term) {
+    unordered_map<string, int>::iterator it = norm.termIDs.find(term);
+    if (it != norm.termIDs.end()) return it->second;
+    int id = static_cast<int>(norm.terms.size());
+    norm.termIDs[term] = id;
+    norm.terms.push_back(term);
+    return id;
+}
 
-        switch (choice) {
-            case 1:
-                getInput(input, "Enter name: ");
-                count = searchByName(items, itemCount, input, results);
-                displayResults(items, results, count);
-                break;
+// Term ID of one raw token, or -1 when no item uses that term
+int knownTermID(const TextNormalizer& norm, const string& token) {
+    unordered_map<string, int>::const_iterator it = norm.termIDs.find(normalizeWord(norm, token));
+    return it == norm.termIDs.end() ? -1 : it->second;
+}
 
-            case 2:
-                getInput(input, "Enter category: ");
-                count = searchByCategory(items, itemCount, input, results);
-                displayResults(items, results, count);
-                break;
+// Term IDs of a text in word order; new terms are added to the dictionary
+vector<int> internTermsOf(TextNormalizer& norm, const string& text) {
+    vector<string> words = tokensOf(text);
+    vector<int> ids(words.size());
+    for (size_t i = 0; i < words.size(); i++) ids[i] = internTerm(norm, normalizeWord(norm, words[i]));
+    return ids;
+}
 
-            case 3:
-                getInput(input, "Enter description: ");
-                count = searchByDescription(items, itemCount, input, results);
-                displayResults(items, results, count);
-                break;
+// Like internTermsOf for text that is not being indexed: unknown terms are -1
+vector<int> knownTermsOf(const TextNormalizer& norm, const string& text) {
+    vector<string> words = tokensOf(text);
+    vector<int> ids(words.size());
+    for (size_t i = 0; i < words.size(); i++) ids[i] = knownTermID(norm, words[i]);
+    return ids;
+}
 
-            case 4:
-                getInput(input, "Enter location: ");
-                count = searchByLocation(items, itemCount, input, results);
-                displayResults(items, results, count);
+vector<int> sortedTermSet(vector<int> ids) {
+    sort(ids.begin(), ids.end());
+    ids.erase(unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
+
+// Normalized terms of one item, computed when it is indexed
+struct ItemTerms {
+    vector<int> name;          // distinct, ascending
+    vector<int> description;   // in word order, for positions
+    vector<int> location;      // distinct, ascending
+    int locationNode;          // resolved node in the location hierarchy, -1 = none
+
+    ItemTerms() : locationNode(-1) {}
+};
+
+// MinHash signatures of descriptions: 4-character shingles of the normalized
+// words, hashed MINHASH_SIZE ways. Two signatures agree in a given position with
+// probability equal to the Jaccard similarity of the shingle sets. For LSH the
+// signature is cut into MINHASH_BANDS bands of MINHASH_ROWS values; items that
+// agree on a whole band share a bucket; with 16 bands of 3 a pair at 0.5
+// similarity meets in some bucket 88% of the time, at 0.7 over 99%.
+const int MINHASH_SIZE = 48;
+const int MINHASH_BANDS = 16;
+const int MINHASH_ROWS = 3;
+const int SHINGLE_LENGTH = 4;
+
+struct MinHashSignature {
+    unsigned int values[MINHASH_SIZE];
+    bool empty;   // no shingles, never bucketed
+};
+
+// splitmix64 finalizer
+unsigned long long mixHash(unsigned long long x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+MinHashSignature minHashOf(const string& text) {
+    vector<string> words = tokensOf(text);
+    string joined;
+    for (size_t i = 0; i < words.size(); i++) joined += (i ? " " : "") + words[i];
+
+    MinHashSignature sig;
+    sig.empty = joined.empty();
+    for (int h = 0; h < MINHASH_SIZE; h++) sig.values[h] = 0xFFFFFFFFu;
+
+    size_t shingles = joined.size() < static_cast<size_t>(SHINGLE_LENGTH) ? 1 : joined.size() - SHINGLE_LENGTH + 1;
+    for (size_t i = 0; !sig.empty && i < shingles; i++) {
+        unsigned long long shingle = 14695981039346656037ULL; // FNV-1a
+        for (size_t j = i; j < i + SHINGLE_LENGTH && j < joined.size(); j++)
+            shingle = (shingle ^ static_cast<unsigned char>(joined[j])) * 1099511628211ULL;
+        for (int h = 0; h < MINHASH_SIZE; h++) {
+            unsigned int value = static_cast<unsigned int>(mixHash(shingle + static_cast<unsigned long long>(h) * 0x632BE59BD9B4E019ULL));
+            if (value < sig.values[h]) sig.values[h] = value;
+        }
+    }
+    return sig;
+}
+
+// Bucket key of one band, distinct across bands
+unsigned long long bandKeyOf(const MinHashSignature& sig, int band) {
+    unsigned long long key = static_cast<unsigned long long>(band);
+    for (int r = 0; r < MINHASH_ROWS; r++)
+        key = mixHash(key ^ sig.values[band * MINHASH_ROWS + r]);
+    return key;
+}
+
+// Estimated Jaccard similarity of the two shingle sets
+double minHashSimilarity(const MinHashSignature& a, const MinHashSignature& b) {
+    if (a.empty || b.empty) return 0.0;
+    int same = 0;
+    for (int h = 0; h < MINHASH_SIZE; h++) same += (a.values[h] == b.values[h]);
+    return static_cast<double>(same) / MINHASH_SIZE;
+}
+
+struct TermPosting {
+    int slot;
+    vector<int> positions;   // word offsets of the term in the description, ascending
+};
+
+bool postingBefore(const TermPosting& posting, int slot) {
+    return posting.slot < slot;
+}
+
+struct ItemIndex {
+    Bitmap statusSlots[2];                 // 0 = Lost, 1 = Found
+    Bitmap categorySlots[CATEGORY_COUNT];  // one per entry of CATEGORIES
+    Bitmap matchedSlots[2];                // indexed by Item::matched
+    Bitmap claimedSlots[2];                // indexed by Item::claimed
+    map<int, Bitmap> dateBuckets;          // day number -> slots, ordered by date
+    map<int, Bitmap> monthBuckets;         // monthKeyOf(date) -> slots, for facets
+    unordered_map<int, Bitmap> nameBigrams; // lower-case name bigram -> slots, for fuzzy search
+    ValueDictionary nameValues;            // distinct names, for autocomplete
+    ValueDictionary locationValues;        // distinct locations, for autocomplete
+    unordered_map<string, Bitmap> personKeys; // phonetic key of each personName word -> slots
+    unordered_map<string, Bitmap> contactSlots; // normalized personContact -> slots
+    TextNormalizer normalizer;             // synonym table and term dictionary
+    vector<ItemTerms> itemTerms;           // normalized terms per slot
+    LocationTree locations;                // optional place hierarchy
+    map<int, Bitmap> locationBuckets;      // DFS number of the resolved location -> slots
+    GeoGrid grid;                          // geo-tagged items
+    unordered_map<int, vector<TermPosting> > descriptionTerms; // description term ID -> postings by slot
+    unordered_map<string, int> nameTokenCounts; // name word -> items whose name has it
+    vector<MinHashSignature> signatures;   // description signature per slot
+    unordered_map<int, int> slotOfID;      // item ID -> slot
+    unordered_map<unsigned long long, Bitmap> lshBuckets; // bandKeyOf -> slots
+    unsigned long epoch;                   // bumped by every mutation, see QueryCache
+
+    ItemIndex() : epoch(0) {}
+};
+
+// Distinct bigram keys of a lower-case string
+vector<int> bigramsOf(const string& lower) {
+    vector<int> grams;
+    for (size_t i = 0; i + 1 < lower.size(); i++)
+        grams.push_back((static_cast<unsigned char>(lower[i]) << 8) | static_cast<unsigned char>(lower[i + 1]));
+    sort(grams.begin(), grams.end());
+    grams.erase(unique(grams.begin(), grams.end()), grams.end());
+    return grams;
+}
+
+// Phonetic key of one word, after Lawrence Philips' original Metaphone rules,
+// so "Jon"/"John", "Smith"/"Smyth" and "Katherine"/"Catherine" share a key
+string metaphoneKey(const string& word) {
+    string w;
+    for (size_t i = 0; i < word.size(); i++) {
+        if (isalpha(static_cast<unsigned char>(word[i])))
+            w += static_cast<char>(toupper(static_cast<unsigned char>(word[i])));
+    }
+    if (w.empty()) return "";
+
+    // Initial letter exceptions
+    size_t start = 0;
+    string key;
+    if (w.compare(0, 2, "AE") == 0 || w.compare(0, 2, "GN") == 0 || w.compare(0, 2, "KN") == 0 ||
+        w.compare(0, 2, "PN") == 0 || w.compare(0, 2, "WR") == 0) {
+        start = 1;
+    } else if (w[0] == 'X') {
+        key = "S";
+        start = 1;
+    } else if (w.compare(0, 2, "WH") == 0) {
+        key = "W";
+        start = 2;
+    }
+
+    const string VOWELS = "AEIOU";
+    int n = static_cast<int>(w.size());
+    for (int i = static_cast<int>(start); i < n && key.size() < 6; i++) {
+        char c = w[i];
+        char prev = i > 0 ? w[i - 1] : '\0';
+        char next = i + 1 < n ? w[i + 1] : '\0';
+        char after = i + 2 < n ? w[i + 2] : '\0';
+        bool nextIsVowel = next != '\0' && VOWELS.find(next) != string::npos;
+        bool frontVowelNext = next == 'I' || next == 'E' || next == 'Y';
+
+        if (c == prev && c != 'C') continue; // doubled letters sound once
+
+        switch (c) {
+            case 'A': case 'E': case 'I': case 'O': case 'U':
+                if (i == static_cast<int>(start)) key += 'A';
+                break;
+            case 'B':
+                if (!(prev == 'M' && next == '\0')) key += 'B';
+                break;
+            case 'C':
+                if (prev == 'S' && frontVowelNext) break;                 // SCI, SCE, SCY
+                if (next == 'I' && after == 'A') key += 'X';              // CIA
+                else if (next == 'H') key += (prev == 'S') ? 'K' : 'X';   // CH, SCH
+                else if (frontVowelNext) key += 'S';
+                else key += 'K';
+                break;
+            case 'D':
+                if (next == 'G' && (after == 'E' || after == 'Y' || after == 'I')) key += 'J';
+                else key += 'T';
+                break;
+            case 'G':
+                if (next == 'H' && after != '\0' && VOWELS.find(after) == string::npos) break;
+                if (next == 'N' && (after == '\0' || (after == 'E' && i + 3 < n && w[i + 3] == 'D'))) break;
+                if (frontVowelNext && prev != 'G') key += 'J';
+                else key += 'K';
+                break;
+            case 'H':
+                if (prev != '\0' && string("CSPTG").find(prev) != string::npos) break;
+                if (prev != '\0' && VOWELS.find(prev) != string::npos && !nextIsVowel) break;
+                key += 'H';
+                break;
+            case 'K':
+                if (prev != 'C') key += 'K';
+                break;
+            case 'P':
+                key += (next == 'H') ? 'F' : 'P';
+                break;
+            case 'Q':
+                key += 'K';
+                break;
+            case 'S':
+                if (next == 'H' || (next == 'I' && (after == 'O' || after == 'A'))) key += 'X';
+                else key += 'S';
+                break;
+            case 'T':
+                if (next == 'I' && (after == 'O' || after == 'A')) key += 'X';
+                else if (next == 'H') key += '0';
+                else if (!(next == 'C' && after == 'H')) key += 'T';
+                break;
+            case 'V':
+                key += 'F';
+                break;
+            case 'W': case 'Y':
+                if (nextIsVowel) key += c;
                 break;
+            case 'X':
+                key += "KS";
+                break;
+            case 'Z':
+                key += 'S';
+                break;
+            default:
+                key += c; // F J L M N R
+        }
+    }
+    return key;
+}
 
-            case 5:
-                getStatus(input);
-                count = searchByStatus(items, itemCount, input, results);
-                displayResults(items, results, count);
+// One key per word of a person's name
+vector<string> phoneticKeysOf(const string& name) {
+    vector<string> keys;
+    string word;
+    for (size_t i = 0; i <= name.size(); i++) {
+        if (i < name.size() && isalpha(static_cast<unsigned char>(name[i]))) {
+            word += name[i];
+        } else if (!word.empty()) {
+            string key = metaphoneKey(word);
+            if (!key.empty() && find(keys.begin(), keys.end(), key) == keys.end())
+                keys.push_back(key);
+            word.clear();
+        }
+    }
+    return keys;
+}
+
+int statusIndexOf(const string& status) {
+    string lower = toLowerCase(status);
+    if (lower == "lost") return 0;
+    if (lower == "found") return 1;
+    return -1;
+}
+
+int categoryIndexOf(const string& category) {
+    for (int i = 0; i < CATEGORY_COUNT; i++) {
+        if (CATEGORIES[i] == category) return i;
+    }
+    return -1;
+}
+
+void indexItem(ItemIndex& index, const Item& item, int slot) {
+    index.epoch++;
+    index.slotOfID[item.id] = slot;
+
+    int s = statusIndexOf(item.status);
+    if (s != -1) bitmapAdd(index.statusSlots[s], slot);
+
+    int c = categoryIndexOf(item.category);
+    if (c != -1) bitmapAdd(index.categorySlots[c], slot);
+
+    bitmapAdd(index.matchedSlots[item.matched ? 1 : 0], slot);
+    bitmapAdd(index.claimedSlots[item.claimed ? 1 : 0], slot);
+
+    bitmapAdd(index.dateBuckets[item.date], slot);
+    bitmapAdd(index.monthBuckets[monthKeyOf(item.date)], slot);
+
+    vector<int> grams = bigramsOf(toLowerCase(item.name));
+    for (size_t i = 0; i < grams.size(); i++)
+        bitmapAdd(index.nameBigrams[grams[i]], slot);
+
+    vector<string> nameWords = tokensOf(item.name);
+    sort(nameWords.begin(), nameWords.end());
+    nameWords.erase(unique(nameWords.begin(), nameWords.end()), nameWords.end());
+    for (size_t i = 0; i < nameWords.size(); i++)
+        index.nameTokenCounts[nameWords[i]]++;
+
+    dictionaryAdd(index.nameValues, item.name);
+    dictionaryAdd(index.locationValues, item.location);
+
+    vector<string> keys = phoneticKeysOf(item.personName);
+    for (size_t i = 0; i < keys.size(); i++)
+        bitmapAdd(index.personKeys[keys[i]], slot);
+
+    string contact = normalizeContact(item.personContact);
+    if (!contact.empty()) bitmapAdd(index.contactSlots[contact], slot);
+
+    if (static_cast<int>(index.signatures.size()) <= slot) index.signatures.resize(slot + 1);
+    index.signatures[slot] = minHashOf(item.description);
+    for (int b = 0; b < MINHASH_BANDS && !index.signatures[slot].empty; b++)
+        bitmapAdd(index.lshBuckets[bandKeyOf(index.signatures[slot], b)], slot);
+
+    if (static_cast<int>(index.itemTerms.size()) <= slot) index.itemTerms.resize(slot + 1);
+    ItemTerms& terms = index.itemTerms[slot];
+    terms.name = sortedTermSet(internTermsOf(index.normalizer, item.name));
+    terms.location = sortedTermSet(internTermsOf(index.normalizer, item.location));
+    terms.description = internTermsOf(index.normalizer, item.description);
+    terms.locationNode = resolveLocation(index.locations, item.location);
+    if (item.hasCoordinates) gridAdd(index.grid, slot, item.latitude, item.longitude);
+    if (terms.locationNode != -1)
+        bitmapAdd(index.locationBuckets[index.locations.nodes[terms.locationNode].enter], slot);
+
+    const vector<int>& words = terms.description;
+    for (size_t i = 0; i < words.size(); i++) {
+        vector<TermPosting>& postings = index.descriptionTerms[words[i]];
+        vector<TermPosting>::iterator it = postings.end();
+        if (!postings.empty() && postings.back().slot >= slot)
+            it = lower_bound(postings.begin(), postings.end(), slot, postingBefore);
+        if (it == postings.end() || it->slot != slot) {
+            TermPosting posting;
+            posting.slot = slot;
+            it = postings.insert(it, posting);
+        }
+        it->positions.push_back(static_cast<int>(i));
+    }
+}
+
+void unindexItem(ItemIndex& index, const Item& item, int slot) {
+    index.epoch++;
+    index.slotOfID.erase(item.id);
+
+    int s = statusIndexOf(item.status);
+    if (s != -1) bitmapRemove(index.statusSlots[s], slot);
+
+    int c = categoryIndexOf(item.category);
+    if (c != -1) bitmapRemove(index.categorySlots[c], slot);
+
+    bitmapRemove(index.matchedSlots[item.matched ? 1 : 0], slot);
+    bitmapRemove(index.claimedSlots[item.claimed ? 1 : 0], slot);
+
+    map<int, Bitmap>::iterator bucket = index.dateBuckets.find(item.date);
+    if (bucket != index.dateBuckets.end()) {
+        bitmapRemove(bucket->second, slot);
+        if (bucket->second.containers.empty()) index.dateBuckets.erase(bucket);
+    }
+    bucket = index.monthBuckets.find(monthKeyOf(item.date));
+    if (bucket != index.monthBuckets.end()) {
+        bitmapRemove(bucket->second, slot);
+        if (bucket->second.containers.empty()) index.monthBuckets.erase(bucket);
+    }
+
+    vector<int> grams = bigramsOf(toLowerCase(item.name));
+    for (size_t i = 0; i < grams.size(); i++) {
+        unordered_map<int, Bitmap>::iterator it = index.nameBigrams.find(grams[i]);
+        if (it == index.nameBigrams.end()) continue;
+        bitmapRemove(it->second, slot);
+        if (it->second.containers.empty()) index.nameBigrams.erase(it);
+    }
+
+    vector<string> nameWords = tokensOf(item.name);
+    sort(nameWords.begin(), nameWords.end());
+    nameWords.erase(unique(nameWords.begin(), nameWords.end()), nameWords.end());
+    for (size_t i = 0; i < nameWords.size(); i++) {
+        unordered_map<string, int>::iterator it = index.nameTokenCounts.find(nameWords[i]);
+        if (it != index.nameTokenCounts.end() && --it->second == 0) index.nameTokenCounts.erase(it);
+    }
+
+    dictionaryRemove(index.nameValues, item.name);
+    dictionaryRemove(index.locationValues, item.location);
+
+    vector<string> keys = phoneticKeysOf(item.personName);
+    for (size_t i = 0; i < keys.size(); i++) {
+        unordered_map<string, Bitmap>::iterator it = index.personKeys.find(keys[i]);
+        if (it == index.personKeys.end()) continue;
+        bitmapRemove(it->second, slot);
+        if (it->second.containers.empty()) index.personKeys.erase(it);
+    }
+
+    unordered_map<string, Bitmap>::iterator contact = index.contactSlots.find(normalizeContact(item.personContact));
+    if (contact != index.contactSlots.end()) {
+        bitmapRemove(contact->second, slot);
+        if (contact->second.containers.empty()) index.contactSlots.erase(contact);
+    }
+
+    for (int b = 0; b < MINHASH_BANDS && slot < static_cast<int>(index.signatures.size()); b++) {
+        unordered_map<unsigned long long, Bitmap>::iterator band = index.lshBuckets.find(bandKeyOf(index.signatures[slot], b));
+        if (band == index.lshBuckets.end()) continue;
+        bitmapRemove(band->second, slot);
+        if (band->second.containers.empty()) index.lshBuckets.erase(band);
+    }
+
+    vector<int> words;
+    if (slot < static_cast<int>(index.itemTerms.size())) {
+        words.swap(index.itemTerms[slot].description);
+        int node = index.itemTerms[slot].locationNode;
+        map<int, Bitmap>::iterator place = (node == -1) ? index.locationBuckets.end()
+                                                        : index.locationBuckets.find(index.locations.nodes[node].enter);
+        if (place != index.locationBuckets.end()) {
+            bitmapRemove(place->second, slot);
+            if (place->second.containers.empty()) index.locationBuckets.erase(place);
+        }
+        index.itemTerms[slot].locationNode = -1;
+    }
+    if (item.hasCoordinates) gridRemove(index.grid, slot, item.latitude, item.longitude);
+    for (size_t i = 0; i < words.size(); i++) {
+        unordered_map<int, vector<TermPosting> >::iterator term = index.descriptionTerms.find(words[i]);
+        if (term == index.descriptionTerms.end()) continue; // repeated word, already removed
+        vector<TermPosting>& postings = term->second;
+        vector<TermPosting>::iterator it = lower_bound(postings.begin(), postings.end(), slot, postingBefore);
+        if (it != postings.end() && it->slot == slot) postings.erase(it);
+        if (postings.empty()) index.descriptionTerms.erase(term);
+    }
+}
+
+// Call after matched/claimed change on an item that is already indexed
+void refreshItemFlags(ItemIndex& index, const Item& item, int slot) {
+    index.epoch++;
+
+    bitmapRemove(index.matchedSlots[1 - (item.matched ? 1 : 0)], slot);
+    bitmapRemove(index.claimedSlots[1 - (item.claimed ? 1 : 0)], slot);
+    bitmapAdd(index.matchedSlots[item.matched ? 1 : 0], slot);
+    bitmapAdd(index.claimedSlots[item.claimed ? 1 : 0], slot);
+}
+
+// Facet counts for a result set: AND-popcounts against the index bitmaps,
+// no second pass over the items themselves
+void displayFacets(const ItemIndex& index, const int results[], int count) {
+    Bitmap hits;
+    for (int i = 0; i < count; i++) bitmapAdd(hits, results[i]);
+
+    cout << "\n---------- Refine ----------\n";
+
+    cout << "Category: ";
+    bool first = true;
+    for (int c = 0; c < CATEGORY_COUNT; c++) {
+        int n = bitmapAndCardinality(hits, index.categorySlots[c]);
+        if (n == 0) continue;
+        cout << (first ? "" : ", ") << CATEGORIES[c] << " (" << n << ")";
+        first = false;
+    }
+
+    cout << "\nStatus:   Lost (" << bitmapAndCardinality(hits, index.statusSlots[0])
+         << "), Found (" << bitmapAndCardinality(hits, index.statusSlots[1]) << ")";
+    cout << "\nMatched:  yes (" << bitmapAndCardinality(hits, index.matchedSlots[1])
+         << "), no (" << bitmapAndCardinality(hits, index.matchedSlots[0]) << ")";
+    cout << "\nClaimed:  yes (" << bitmapAndCardinality(hits, index.claimedSlots[1])
+         << "), no (" << bitmapAndCardinality(hits, index.claimedSlots[0]) << ")";
+
+    cout << "\nMonth:    ";
+    first = true;
+    for (map<int, Bitmap>::const_reverse_iterator it = index.monthBuckets.rbegin(); it != index.monthBuckets.rend(); ++it) {
+        int n = bitmapAndCardinality(hits, it->second);
+        if (n == 0) continue;
+
+        char month[16];
+        snprintf(month, sizeof(month), "%04d-%02d", it->first / 12, it->first % 12 + 1);
+        cout << (first ? "" : ", ") << month << " (" << n << ")";
+        first = false;
+    }
+    cout << "\n";
+}
+
+// Used whenever slots shift (load, delete, sort, clear)
+void rebuildIndex(ItemIndex& index, Item items[], int itemCount) {
+    unsigned long epoch = index.epoch;
+    unordered_map<string, string> synonyms;
+    synonyms.swap(index.normalizer.synonyms);
+    LocationTree locations;
+    swap(locations, index.locations);
+    index = ItemIndex();
+    index.epoch = epoch + 1; // never reuse an epoch, cached results would look fresh
+    index.normalizer.synonyms.swap(synonyms);
+    swap(index.locations, locations);
+    for (int i = 0; i < itemCount; i++)
+        indexItem(index, items[i], i);
+}
+
+
+
+
+
+
+
+// Field Statistics
+// Distinct counts, heavy hitters and the date histogram, all read from the
+// counts the index already keeps up to date on every add, update and delete.
+// The query planner uses the same counts to estimate predicate selectivity.
+
+const int STATS_TOP_N = 5;
+
+int dictionaryCount(const ValueDictionary& dict, const string& value) {
+    string key = toLowerCase(value);
+    int pos = findDictionaryEntry(dict, key);
+    if (pos < static_cast<int>(dict.entries.size()) && dict.entries[pos].key == key)
+        return dict.entries[pos].count;
+    return 0;
+}
+
+// Items whose value contains text, summed over the distinct values
+int dictionaryContainsCount(const ValueDictionary& dict, const string& text) {
+    string needle = toLowerCase(text);
+    int total = 0;
+    for (size_t i = 0; i < dict.entries.size(); i++) {
+        if (dict.entries[i].key.find(needle) != string::npos) total += dict.entries[i].count;
+    }
+    return total;
+}
+
+void displayTopValues(const char* title, vector<pair<int, string> > counts, int itemCount) {
+    size_t n = min(counts.size(), static_cast<size_t>(STATS_TOP_N));
+    partial_sort(counts.begin(), counts.begin() + n, counts.end(), greater<pair<int, string> >());
+
+    cout << title << "\n";
+    for (size_t i = 0; i < n; i++) {
+        printf("  %-24s %6d  %5.1f%%\n", counts[i].second.c_str(), counts[i].first,
+               itemCount > 0 ? 100.0 * counts[i].first / itemCount : 0.0);
+    }
+}
+
+void displayStatistics(const ItemIndex& index, int itemCount) {
+    cout << "\n========== STATISTICS (" << itemCount << " items) ==========\n";
+
+    cout << "\nDistinct values\n";
+    printf("  %-24s %6d\n", "names", static_cast<int>(index.nameValues.entries.size()));
+    printf("  %-24s %6d\n", "name words", static_cast<int>(index.nameTokenCounts.size()));
+    printf("  %-24s %6d\n", "description words", static_cast<int>(index.descriptionTerms.size()));
+    printf("  %-24s %6d\n", "locations", static_cast<int>(index.locationValues.entries.size()));
+    printf("  %-24s %6d\n", "dates", static_cast<int>(index.dateBuckets.size()));
+    printf("  %-24s %6d\n", "contacts", static_cast<int>(index.contactSlots.size()));
+
+    vector<pair<int, string> > counts;
+    for (int c = 0; c < CATEGORY_COUNT; c++)
+        counts.push_back(make_pair(bitmapCardinality(index.categorySlots[c]), CATEGORIES[c]));
+    cout << "\n";
+    displayTopValues("Top categories", counts, itemCount);
+
+    counts.clear();
+    for (size_t i = 0; i < index.locationValues.entries.size(); i++)
+        counts.push_back(make_pair(index.locationValues.entries[i].count, index.locationValues.entries[i].display));
+    cout << "\n";
+    displayTopValues("Top locations", counts, itemCount);
+
+    counts.clear();
+    for (unordered_map<string, int>::const_iterator it = index.nameTokenCounts.begin(); it != index.nameTokenCounts.end(); ++it)
+        counts.push_back(make_pair(it->second, it->first));
+    cout << "\n";
+    displayTopValues("Top name words", counts, itemCount);
+
+    cout << "\nStatus: Lost " << bitmapCardinality(index.statusSlots[0])
+         << ", Found " << bitmapCardinality(index.statusSlots[1])
+         << "   Matched: " << bitmapCardinality(index.matchedSlots[1])
+         << "   Claimed: " << bitmapCardinality(index.claimedSlots[1]) << "\n";
+
+    // One bar per month, scaled to the busiest month
+    int busiest = 0;
+    for (map<int, Bitmap>::const_iterator it = index.monthBuckets.begin(); it != index.monthBuckets.end(); ++it)
+        busiest = max(busiest, bitmapCardinality(it->second));
+
+    cout << "\nItems per month\n";
+    for (map<int, Bitmap>::const_iterator it = index.monthBuckets.begin(); it != index.monthBuckets.end(); ++it) {
+        int n = bitmapCardinality(it->second);
+        printf("  %04d-%02d %6d  %s\n", it->first / 12, it->first % 12 + 1, n,
+               string(busiest > 0 ? (n * 40 + busiest - 1) / busiest : 0, '#').c_str());
+    }
+}
+
+
+
+
+
+
+
+// File Operations
+
+void saveToFile(fstream& file, Item* items, int itemCount, int nextID, const char* filename) {
+    file.open(filename, ios::out | ios::binary);
+    if (!file) {
+        cout << "File can't be opened.\n";
+        return;
+    }
+
+    // header
+    file.write(reinterpret_cast<char*>(&nextID), sizeof(nextID));
+    file.write(reinterpret_cast<char*>(&itemCount), sizeof(itemCount));
+
+    for (int i = 0; i < itemCount; i++) {
+
+        // id
+        file.write(reinterpret_cast<char*>(&items[i].id), sizeof(items[i].id));
+
+        // name
+        size_t len = items[i].name.length();
+        file.write(reinterpret_cast<char*>(&len), sizeof(len));
+        file.write(items[i].name.c_str(), len);
+
+        // category
+        len = items[i].category.length();
+        file.write(reinterpret_cast<char*>(&len), sizeof(len));
+        file.write(items[i].category.c_str(), len);
+
+        // description
+        len = items[i].description.length();
+        file.write(reinterpret_cast<char*>(&len), sizeof(len));
+        file.write(items[i].description.c_str(), len);
+
+        // date (fixed 12-byte YYYY-MM-DD text, same layout as older files)
+        char dateText[12] = {0};
+        strncpy(dateText, formatDate(items[i].date).c_str(), 10);
+        file.write(dateText, sizeof(dateText));
+
+        // location
+        len = items[i].location.length();
+        file.write(reinterpret_cast<char*>(&len), sizeof(len));
+        file.write(items[i].location.c_str(), len);
+
+        // status
+        len = items[i].status.length();
+        file.write(reinterpret_cast<char*>(&len), sizeof(len));
+        file.write(items[i].status.c_str(), len);
+
+        // flags
+        file.write(reinterpret_cast<char*>(&items[i].matched), sizeof(items[i].matched));
+        file.write(reinterpret_cast<char*>(&items[i].claimed), sizeof(items[i].claimed));
+        file.write(reinterpret_cast<char*>(&items[i].matchedItemID), sizeof(items[i].matchedItemID));
+
+        // person name
+        len = items[i].personName.length();
+        file.write(reinterpret_cast<char*>(&len), sizeof(len));
+        file.write(items[i].personName.c_str(), len);
+
+        // person contact
+        len = items[i].personContact.length();
+        file.write(reinterpret_cast<char*>(&len), sizeof(len));
+        file.write(items[i].personContact.c_str(), len);
+    }
+
+    // Coordinates go in a trailing section that older versions never read:
+    // "GEO1", count, then (slot, latitude, longitude) per geo-tagged item
+    int tagged = 0;
+    for (int i = 0; i < itemCount; i++) tagged += items[i].hasCoordinates;
+    if (tagged > 0) {
+        file.write("GEO1", 4);
+        file.write(reinterpret_cast<char*>(&tagged), sizeof(tagged));
+        for (int i = 0; i < itemCount; i++) {
+            if (!items[i].hasCoordinates) continue;
+            file.write(reinterpret_cast<char*>(&i), sizeof(i));
+            file.write(reinterpret_cast<char*>(&items[i].latitude), sizeof(items[i].latitude));
+            file.write(reinterpret_cast<char*>(&items[i].longitude), sizeof(items[i].longitude));
+        }
+    }
+
+    file.close();
+}
+
+void loadFromFile(fstream& file, Item*& items, int& itemCount, int& capacity, int& nextID, const char* filename) {
+    file.open(filename, ios::in | ios::binary);
+    if (!file) {
+        itemCount = 0;
+        nextID = 100;
+        return;
+    }
+
+    // Read header safely
+    if (!file.read(reinterpret_cast<char*>(&nextID), sizeof(nextID)) ||
+        !file.read(reinterpret_cast<char*>(&itemCount), sizeof(itemCount))) {
+        itemCount = 0;
+        nextID = 100;
+        file.close();
+        return;
+    }
+
+    if (itemCount > capacity) {
+        while (capacity < itemCount)
+            capacity *= 2;
+
+        delete[] items;
+        items = new Item[capacity];
+    }
+
+    for (int i = 0; i < itemCount; i++) {
+
+        // id
+        file.read(reinterpret_cast<char*>(&items[i].id), sizeof(items[i].id));
+
+        size_t len;
+        char* buffer;
+
+        // name
+        file.read(reinterpret_cast<char*>(&len), sizeof(len));
+        buffer = new char[len + 1];
+        file.read(buffer, len);
+        buffer[len] = '\0';
+        items[i].name.assign(buffer, len);
+        delete[] buffer;
+
+        // category
+        file.read(reinterpret_cast<char*>(&len), sizeof(len));
+        buffer = new char[len + 1];
+        file.read(buffer, len);
+        buffer[len] = '\0';
+        items[i].category.assign(buffer, len);
+        delete[] buffer;
+
+        // description
+        file.read(reinterpret_cast<char*>(&len), sizeof(len));
+        buffer = new char[len + 1];
+        file.read(buffer, len);
+        buffer[len] = '\0';
+        items[i].description.assign(buffer, len);
+        delete[] buffer;
+
+        // date
+        char dateText[12] = {0};
+        string dateError;
+        file.read(dateText, sizeof(dateText));
+        dateText[11] = '\0';
+        if (!parseDate(dateText, items[i].date, dateError))
+            items[i].date = 0; // every saved date was validated on entry, so this only catches corrupt files
+
+        // location
+        file.read(reinterpret_cast<char*>(&len), sizeof(len));
+        buffer = new char[len + 1];
+        file.read(buffer, len);
+        buffer[len] = '\0';
+        items[i].location.assign(buffer, len);
+        delete[] buffer;
+
+        // status
+        file.read(reinterpret_cast<char*>(&len), sizeof(len));
+        buffer = new char[len + 1];
+        file.read(buffer, len);
+        buffer[len] = '\0';
+        items[i].status.assign(buffer, len);
+        delete[] buffer;
+
+        // flags
+        file.read(reinterpret_cast<char*>(&items[i].matched), sizeof(items[i].matched));
+        file.read(reinterpret_cast<char*>(&items[i].claimed), sizeof(items[i].claimed));
+        file.read(reinterpret_cast<char*>(&items[i].matchedItemID), sizeof(items[i].matchedItemID));
+
+        // person name
+        file.read(reinterpret_cast<char*>(&len), sizeof(len));
+        buffer = new char[len + 1];
+        file.read(buffer, len);
+        buffer[len] = '\0';
+        items[i].personName.assign(buffer, len);
+        delete[] buffer;
+
+        // person contact
+        file.read(reinterpret_cast<char*>(&len), sizeof(len));
+        buffer = new char[len + 1];
+        file.read(buffer, len);
+        buffer[len] = '\0';
+        items[i].personContact.assign(buffer, len);
+        delete[] buffer;
+        items[i].hasCoordinates = false;
+    }
+
+    // Optional trailing coordinates section, absent in older files
+    char magic[4];
+    int tagged = 0;
+    if (file.read(magic, sizeof(magic)) && memcmp(magic, "GEO1", 4) == 0 &&
+        file.read(reinterpret_cast<char*>(&tagged), sizeof(tagged))) {
+        for (int t = 0; t < tagged; t++) {
+            int slot;
+            double latitude, longitude;
+            if (!file.read(reinterpret_cast<char*>(&slot), sizeof(slot)) ||
+                !file.read(reinterpret_cast<char*>(&latitude), sizeof(latitude)) ||
+                !file.read(reinterpret_cast<char*>(&longitude), sizeof(longitude)))
+                break;
+            if (slot < 0 || slot >= itemCount) continue;
+            items[slot].hasCoordinates = true;
+            items[slot].latitude = latitude;
+            items[slot].longitude = longitude;
+        }
+    }
+
+    file.close();
+}
+
+
+void viewFromFile(const char* filename, fstream& file) {
+    int itemCount = 0;
+    int capacity = 10;  // initial capacity
+    int nextID = 100;
+
+    Item* items = new Item[capacity];
+
+    loadFromFile(file, items, itemCount, capacity, nextID, filename);
+
+    if (itemCount == 0) {
+        cout << "\nNo items to display.\n";
+        delete[] items;
+        return;
+    }
+
+cout << "\n===========================================================================================================================\n";
+cout << "\n====================    ITEMS ON RECORD    ================================================================================\n";
+
+    for (int i = 0; i < itemCount; i++) {
+        cout << "Item " << i + 1 << ":\n";
+        displayItem(items[i]);
+        
+    }
+
+    delete[] items;
+}
+
+void clearAllItems(Item items[], int& itemCount, ItemIndex& index, int& nextID, const char* filename) {
+    string confirm;
+
+    while (true) {
+        cout << "Are you sure you want to delete ALL items? (Y/N): ";
+        getline(cin, confirm);
+
+        if (confirm == "Y" || confirm == "y") {
+            ofstream out(filename, ios::binary | ios::trunc);
+            if (!out) {
+                cout << "Error clearing file!\n";
+                return;
+            }
+            out.close();
+
+            itemCount = 0;
+            nextID = 100;
+            rebuildIndex(index, items, itemCount);
+            cout << "All items cleared successfully.\n";
+            return;
+        }
+        else if (confirm == "N" || confirm == "n") {
+            cout << "Operation cancelled. No items were deleted.\n";
+            return;
+        }
+        else {
+            cout << "Invalid input. Please enter only Y or N.\n";
+        }
+    }
+}
+
+
+
+
+
+
+
+
+
+
+
+// Query Engine
+// A query is a flat conjunction (AND) or disjunction (OR) of field predicates,
+// written as e.g.  status=Lost AND category=Electronics AND location~Library
+// Operators: = equals, ~ contains, <, <=, >, >= (date and id only).
+// AND / OR must be upper case; a lower-case "and" or anything in double quotes
+// is part of the value, e.g.  description~"black and white" OR location~Library and Cafe
+
+enum QueryField {
+    FIELD_ID, FIELD_NAME, FIELD_CATEGORY, FIELD_DESCRIPTION, FIELD_DATE, FIELD_LOCATION,
+    FIELD_STATUS, FIELD_MATCHED, FIELD_CLAIMED, FIELD_PERSON_NAME, FIELD_PERSON_CONTACT
+};
+
+enum QueryOp { OP_EQUALS, OP_CONTAINS, OP_LESS, OP_LESS_EQUAL, OP_GREATER, OP_GREATER_EQUAL };
+
+const char* const FIELD_NAMES[] = {
+    "id", "name", "category", "description", "date", "location",
+    "status", "matched", "claimed", "person", "contact"
+};
+
+const int FIELD_COUNT = 11;
+
+struct QueryPredicate {
+    int field;
+    int op;
+    string value;
+    int date;          // parsed value for date comparisons
+    double estimate;   // estimated number of matching items, filled by the planner
+    bool indexed;      // true when the predicate can be answered from a bitmap
+};
+
+struct Query {
+    vector<QueryPredicate> predicates;
+    bool anyOf;        // false = all predicates (AND), true = any predicate (OR)
+};
+
+string trimSpaces(const string& s) {
+    size_t start = s.find_first_not_of(" \t");
+    if (start == string::npos) return "";
+    size_t end = s.find_last_not_of(" \t");
+    return s.substr(start, end - start + 1);
+}
+
+int flagValueOf(const string& value) {
+    string lower = toLowerCase(value);
+    if (lower == "1" || lower == "yes" || lower == "true") return 1;
+    if (lower == "0" || lower == "no" || lower == "false") return 0;
+    return -1;
+}
+
+bool parsePredicate(const string& text, QueryPredicate& pred, string& error) {
+    size_t opPos = text.find_first_of("=~<>");
+    if (opPos == string::npos) {
+        error = "Missing operator in '" + text + "'";
+        return false;
+    }
+
+    string field = toLowerCase(trimSpaces(text.substr(0, opPos)));
+    pred.field = -1;
+    for (int i = 0; i < FIELD_COUNT; i++) {
+        if (field == FIELD_NAMES[i]) pred.field = i;
+    }
+    if (pred.field == -1) {
+        error = "Unknown field '" + field + "'";
+        return false;
+    }
+
+    char op = text[opPos];
+    size_t valuePos = opPos + 1;
+    bool orEqual = valuePos < text.size() && text[valuePos] == '=';
+    if (op == '=' || op == '~') {
+        pred.op = (op == '=') ? OP_EQUALS : OP_CONTAINS;
+    } else {
+        if (orEqual) valuePos++;
+        if (op == '<') pred.op = orEqual ? OP_LESS_EQUAL : OP_LESS;
+        else pred.op = orEqual ? OP_GREATER_EQUAL : OP_GREATER;
+        if (pred.field != FIELD_DATE && pred.field != FIELD_ID) {
+            error = "Comparison operators only apply to date and id";
+            return false;
+        }
+    }
+
+    pred.value = trimSpaces(text.substr(valuePos));
+    if (pred.value.size() >= 2 && pred.value[0] == '"' && pred.value[pred.value.size() - 1] == '"')
+        pred.value = pred.value.substr(1, pred.value.size() - 2);
+    if (pred.value.empty()) {
+        error = "Missing value for '" + field + "'";
+        return false;
+    }
+    pred.date = 0;
+    if (pred.field == FIELD_DATE && pred.op != OP_CONTAINS && !parseDate(pred.value, pred.date, error))
+        return false;
+    if ((pred.field == FIELD_MATCHED || pred.field == FIELD_CLAIMED) && flagValueOf(pred.value) == -1) {
+        error = "Use yes/no (or 1/0) for '" + field + "'";
+        return false;
+    }
+
+    pred.estimate = 0;
+    pred.indexed = false;
+    return true;
+}
+
+bool parseQuery(const string& text, Query& query, string& error) {
+    query.predicates.clear();
+    query.anyOf = false;
+
+    // Split on the AND / OR keywords outside quotes; mixing them is not supported
+    bool sawAnd = false, sawOr = false, quoted = false;
+    size_t start = 0;
+    for (size_t i = 0; i <= text.size(); i++) {
+        size_t keyword = 0;
+        if (i < text.size()) {
+            if (text[i] == '"') quoted = !quoted;
+            if (quoted) continue;
+            if (text.compare(i, 5, " AND ") == 0) keyword = 5;
+            else if (text.compare(i, 4, " OR ") == 0) keyword = 4;
+            else continue;
+        } else if (quoted) {
+            error = "Missing closing quote";
+            return false;
+        }
+
+        QueryPredicate pred;
+        if (!parsePredicate(text.substr(start, i - start), pred, error)) return false;
+        query.predicates.push_back(pred);
+
+        if (keyword == 0) break;
+        if (keyword == 5) sawAnd = true;
+        if (keyword == 4) sawOr = true;
+        start = i + keyword;
+        i = start - 1;
+    }
+
+    if (sawAnd && sawOr) {
+        error = "Use either AND or OR in one query, not both";
+        return false;
+    }
+    query.anyOf = sawOr;
+    return true;
+}
+
+bool compareOrdered(int cmp, int op) {
+    switch (op) {
+        case OP_EQUALS: return cmp == 0;
+        case OP_LESS: return cmp < 0;
+        case OP_LESS_EQUAL: return cmp <= 0;
+        case OP_GREATER: return cmp > 0;
+        case OP_GREATER_EQUAL: return cmp >= 0;
+    }
+    return false;
+}
+
+bool matchText(const string& field, const QueryPredicate& pred) {
+    if (pred.op == OP_CONTAINS) return containsSubstring(field, pred.value);
+    return toLowerCase(field) == toLowerCase(pred.value);
+}
+
+bool itemMatchesPredicate(const Item& item, const QueryPredicate& pred) {
+    switch (pred.field) {
+        case FIELD_ID: {
+            int value = atoi(pred.value.c_str());
+            return compareOrdered(item.id < value ? -1 : (item.id > value ? 1 : 0),
+                                  pred.op == OP_CONTAINS ? OP_EQUALS : pred.op);
+        }
+        case FIELD_NAME: return matchText(item.name, pred);
+        case FIELD_CATEGORY: return matchText(item.category, pred);
+        case FIELD_DESCRIPTION: return matchText(item.description, pred);
+        case FIELD_DATE:
+            if (pred.op == OP_CONTAINS) return containsSubstring(formatDate(item.date), pred.value);
+            return compareOrdered(item.date < pred.date ? -1 : (item.date > pred.date ? 1 : 0), pred.op);
+        case FIELD_LOCATION: return matchText(item.location, pred);
+        case FIELD_STATUS: return matchText(item.status, pred);
+        case FIELD_MATCHED: return item.matched == flagValueOf(pred.value);
+        case FIELD_CLAIMED: return item.claimed == flagValueOf(pred.value);
+        case FIELD_PERSON_NAME: return matchText(item.personName, pred);
+        case FIELD_PERSON_CONTACT:
+            if (pred.op == OP_EQUALS) return normalizeContact(item.personContact) == normalizeContact(pred.value);
+            return matchText(item.personContact, pred);
+    }
+    return false;
+}
+
+// Returns true and fills bm when the predicate can be answered from the bitmap index
+bool predicateBitmap(const ItemIndex& index, const QueryPredicate& pred, Bitmap& bm) {
+    switch (pred.field) {
+        case FIELD_STATUS: {
+            if (pred.op != OP_EQUALS) return false;
+            int s = statusIndexOf(pred.value);
+            bm = (s == -1) ? Bitmap() : index.statusSlots[s];
+            return true;
+        }
+        case FIELD_CATEGORY: {
+            bm = Bitmap();
+            for (int c = 0; c < CATEGORY_COUNT; c++) {
+                if (pred.op == OP_EQUALS ? toLowerCase(CATEGORIES[c]) == toLowerCase(pred.value)
+                                         : containsSubstring(CATEGORIES[c], pred.value))
+                    bm = bitmapOr(bm, index.categorySlots[c]);
+            }
+            return true;
+        }
+        case FIELD_DATE: {
+            if (pred.op == OP_CONTAINS) return false;
+            int key = pred.date;
+
+            map<int, Bitmap>::const_iterator from = index.dateBuckets.begin();
+            map<int, Bitmap>::const_iterator to = index.dateBuckets.end();
+            if (pred.op == OP_EQUALS || pred.op == OP_GREATER_EQUAL) from = index.dateBuckets.lower_bound(key);
+            if (pred.op == OP_GREATER) from = index.dateBuckets.upper_bound(key);
+            if (pred.op == OP_EQUALS || pred.op == OP_LESS_EQUAL) to = index.dateBuckets.upper_bound(key);
+            if (pred.op == OP_LESS) to = index.dateBuckets.lower_bound(key);
+
+            bm = bucketUnion(from, to);
+            return true;
+        }
+        case FIELD_PERSON_CONTACT: {
+            if (pred.op != OP_EQUALS) return false;
+            unordered_map<string, Bitmap>::const_iterator it = index.contactSlots.find(normalizeContact(pred.value));
+            bm = (it == index.contactSlots.end()) ? Bitmap() : it->second;
+            return true;
+        }
+        case FIELD_MATCHED:
+            bm = index.matchedSlots[flagValueOf(pred.value)];
+            return true;
+        case FIELD_CLAIMED:
+            bm = index.claimedSlots[flagValueOf(pred.value)];
+            return true;
+    }
+    return false;
+}
+
+// Rough fraction of items a non-indexed predicate keeps
+double defaultSelectivity(const QueryPredicate& pred) {
+    if (pred.field == FIELD_ID) return pred.op == OP_EQUALS || pred.op == OP_CONTAINS ? 0.0 : 0.5;
+    if (pred.field == FIELD_DATE) return pred.op == OP_EQUALS ? 0.02 : 0.3;
+    return pred.op == OP_EQUALS ? 0.05 : 0.2;
+}
+
+// Estimate from the field statistics for text predicates; false when there are none.
+// Word and bigram counts give upper bounds, the location dictionary an exact count.
+bool statisticsEstimate(const ItemIndex& index, const QueryPredicate& pred, double& estimate) {
+    string value = toLowerCase(pred.value);
+    if (pred.field == FIELD_LOCATION) {
+        estimate = (pred.op == OP_EQUALS) ? dictionaryCount(index.locationValues, value)
+                                          : dictionaryContainsCount(index.locationValues, value);
+        return true;
+    }
+
+    if (pred.field == FIELD_NAME) {
+        if (pred.op == OP_EQUALS) {
+            estimate = dictionaryCount(index.nameValues, value);
+            return true;
+        }
+        vector<int> grams = bigramsOf(value);
+        if (grams.empty()) return false;
+        int fewest = -1;
+        for (size_t i = 0; i < grams.size(); i++) {
+            unordered_map<int, Bitmap>::const_iterator it = index.nameBigrams.find(grams[i]);
+            int n = (it == index.nameBigrams.end()) ? 0 : bitmapCardinality(it->second);
+            if (fewest == -1 || n < fewest) fewest = n;
+        }
+        estimate = fewest;
+        return true;
+    }
+
+    if (pred.field == FIELD_DESCRIPTION) {
+        // Only whole words have a posting list to count. A contains value that is
+        // not an indexed word ("leath") may still be part of one, so no estimate.
+        vector<string> words = tokensOf(value);
+        if (words.empty() || (pred.op == OP_CONTAINS && words.size() == 1 && words[0] != value)) return false;
+        int fewest = -1;
+        for (size_t i = 0; i < words.size(); i++) {
+            int term = knownTermID(index.normalizer, words[i]);
+            if (term == -1 && pred.op == OP_CONTAINS) return false;
+            unordered_map<int, vector<TermPosting> >::const_iterator it = index.descriptionTerms.find(term);
+            int n = (it == index.descriptionTerms.end()) ? 0 : static_cast<int>(it->second.size());
+            if (fewest == -1 || n < fewest) fewest = n;
+        }
+        estimate = fewest;
+        return true;
+    }
+    return false;
+}
+
+// Fills estimate/indexed for every predicate and orders them most selective first
+void planQuery(const ItemIndex& index, int itemCount, Query& query) {
+    for (size_t i = 0; i < query.predicates.size(); i++) {
+        QueryPredicate& pred = query.predicates[i];
+        Bitmap bm;
+        pred.indexed = predicateBitmap(index, pred, bm);
+        if (pred.indexed)
+            pred.estimate = bitmapCardinality(bm);
+        else if (pred.field == FIELD_ID && (pred.op == OP_EQUALS || pred.op == OP_CONTAINS))
+            pred.estimate = 1;
+        else if (!statisticsEstimate(index, pred, pred.estimate))
+            pred.estimate = defaultSelectivity(pred) * itemCount;
+    }
+
+    // Insertion sort keeps the original order among equal estimates
+    for (size_t i = 1; i < query.predicates.size(); i++) {
+        QueryPredicate key = query.predicates[i];
+        size_t j = i;
+        while (j > 0 && query.predicates[j - 1].estimate > key.estimate) {
+            query.predicates[j] = query.predicates[j - 1];
+            j--;
+        }
+        query.predicates[j] = key;
+    }
+}
+
+void explainQuery(const Query& query) {
+    cout << "Plan (" << (query.anyOf ? "any of" : "all of") << "):\n";
+    for (size_t i = 0; i < query.predicates.size(); i++) {
+        const QueryPredicate& pred = query.predicates[i];
+        cout << "  " << i + 1 << ". " << FIELD_NAMES[pred.field] << " '" << pred.value << "'"
+             << (pred.indexed ? " [bitmap]" : " [verify]")
+             << " ~" << static_cast<int>(pred.estimate + 0.5) << " items\n";
+    }
+}
+
+// Runs a planned query, writes matching slots in ascending order into results
+int runQuery(Item items[], int itemCount, const ItemIndex& index, const Query& query, int results[]) {
+    int count = 0;
+
+    if (query.anyOf) {
+        // Union every indexed predicate, then scan the rest only for slots not yet in the union
+        Bitmap hits;
+        vector<const QueryPredicate*> verify;
+        for (size_t i = 0; i < query.predicates.size(); i++) {
+            Bitmap bm;
+            if (predicateBitmap(index, query.predicates[i], bm)) hits = bitmapOr(hits, bm);
+            else verify.push_back(&query.predicates[i]);
+        }
+        for (int i = 0; i < itemCount; i++) {
+            bool keep = bitmapContains(hits, i);
+            for (size_t p = 0; !keep && p < verify.size(); p++)
+                keep = itemMatchesPredicate(items[i], *verify[p]);
+            if (keep) results[count++] = i;
+        }
+        return count;
+    }
+
+    // Conjunction: intersect indexed predicates starting from the most selective,
+    // then verify the remaining predicates on the surviving candidates only
+    Bitmap candidates;
+    bool haveCandidates = false;
+    vector<const QueryPredicate*> verify;
+    for (size_t i = 0; i < query.predicates.size(); i++) {
+        Bitmap bm;
+        if (predicateBitmap(index, query.predicates[i], bm)) {
+            candidates = haveCandidates ? bitmapAnd(candidates, bm) : bm;
+            haveCandidates = true;
+        } else {
+            verify.push_back(&query.predicates[i]);
+        }
+    }
+
+    if (haveCandidates) {
+        int* slots = new int[bitmapCardinality(candidates)];
+        int candidateCount = bitmapToArray(candidates, slots);
+        for (int i = 0; i < candidateCount; i++) {
+            bool keep = true;
+            for (size_t p = 0; keep && p < verify.size(); p++)
+                keep = itemMatchesPredicate(items[slots[i]], *verify[p]);
+            if (keep) results[count++] = slots[i];
+        }
+        delete[] slots;
+    } else {
+        for (int i = 0; i < itemCount; i++) {
+            bool keep = true;
+            for (size_t p = 0; keep && p < verify.size(); p++)
+                keep = itemMatchesPredicate(items[i], *verify[p]);
+            if (keep) results[count++] = i;
+        }
+    }
+    return count;
+}
+
+// Canonical text for a query: predicates sorted so "a AND b" and "b AND a" share a key
+string normalizeQuery(const Query& query) {
+    vector<string> parts;
+    for (size_t i = 0; i < query.predicates.size(); i++) {
+        const QueryPredicate& pred = query.predicates[i];
+        static const char* const OP_TEXT[] = {"=", "~", "<", "<=", ">", ">="};
+        parts.push_back(string(FIELD_NAMES[pred.field]) + OP_TEXT[pred.op] + toLowerCase(pred.value));
+    }
+    sort(parts.begin(), parts.end());
+
+    string key;
+    for (size_t i = 0; i < parts.size(); i++) {
+        if (i > 0) key += query.anyOf ? " OR " : " AND ";
+        key += parts[i];
+    }
+    return key;
+}
+
+
+
+
+
+
+
+// Pattern Search
+// Regular expressions (. [] ? * + | () and \d \w \s) and globs (* ? []) over
+// names and descriptions, case-insensitive. A pattern is compiled once into a
+// DFA; the literals every match must contain are pulled out of it first so the
+// plain substring check can discard most items before the automaton runs.
+// Anything outside that syntax (\D, \b, ^, $, reversed ranges) is an error
+// rather than a silent literal.
+
+const int PATTERN_MAX_STATES = 4096;
+
+enum PatternNodeType { PATTERN_CHARS, PATTERN_CONCAT, PATTERN_ALT, PATTERN_STAR, PATTERN_PLUS, PATTERN_OPTIONAL, PATTERN_EMPTY };
+
+struct PatternNode {
+    int type;
+    bitset<256> chars;   // PATTERN_CHARS only
+    int left, right;     // child nodes, -1 when unused
+};
+
+struct PatternParser {
+    string text;
+    size_t pos;
+    vector<PatternNode> nodes;
+    string error;
+};
+
+struct CompiledPattern {
+    vector<int> transitions;   // state * 256 + byte -> next state, -1 = no match possible
+    vector<bool> accepting;
+    bool anchored;             // glob: the whole field must match; regex: anywhere in it
+    vector<string> literals;   // lower-case strings every matching field contains
+};
+
+int addPatternNode(PatternParser& p, int type, int left = -1, int right = -1) {
+    PatternNode node;
+    node.type = type;
+    node.left = left;
+    node.right = right;
+    p.nodes.push_back(node);
+    return static_cast<int>(p.nodes.size()) - 1;
+}
+
+void addPatternChar(bitset<256>& chars, unsigned char c) {
+    chars.set(static_cast<unsigned char>(tolower(c)));
+}
+
+int parsePatternAlternation(PatternParser& p);
+
+int parsePatternAtom(PatternParser& p) {
+    char c = p.text[p.pos++];
+    int node = addPatternNode(p, PATTERN_CHARS);
+
+    if (c == '(') {
+        p.nodes.pop_back();
+        int inner = parsePatternAlternation(p);
+        if (p.pos >= p.text.size() || p.text[p.pos] != ')') {
+            p.error = "Missing ')'";
+            return -1;
+        }
+        p.pos++;
+        return inner;
+    }
+
+    if (c == '.') {
+        p.nodes[node].chars.set();
+    } else if (c == '[') {
+        bool negate = p.pos < p.text.size() && p.text[p.pos] == '^';
+        if (negate) p.pos++;
+        bitset<256> chars;
+        bool first = true;
+        while (p.pos < p.text.size() && (p.text[p.pos] != ']' || first)) {
+            unsigned char from = static_cast<unsigned char>(p.text[p.pos++]);
+            unsigned char to = from;
+            if (p.pos + 1 < p.text.size() && p.text[p.pos] == '-' && p.text[p.pos + 1] != ']') {
+                to = static_cast<unsigned char>(p.text[p.pos + 1]);
+                p.pos += 2;
+                if (to < from) {
+                    p.error = string("Reversed range '") + char(from) + "-" + char(to) + "'";
+                    return -1;
+                }
+            }
+            for (int ch = from; ch <= to; ch++) addPatternChar(chars, static_cast<unsigned char>(ch));
+            first = false;
+        }
+        if (p.pos >= p.text.size()) {
+            p.error = "Missing ']'";
+            return -1;
+        }
+        p.pos++;
+        if (negate) {
+            chars.flip();
+            for (int ch = 'A'; ch <= 'Z'; ch++) chars.reset(ch); // text is lower-cased before matching
+        }
+        p.nodes[node].chars = chars;
+    } else if (c == '\\') {
+        if (p.pos >= p.text.size()) {
+            p.error = "Pattern ends with '\\'";
+            return -1;
+        }
+        char e = p.text[p.pos++];
+        if (isalnum(static_cast<unsigned char>(e)) && e != 'd' && e != 's' && e != 'w') {
+            p.error = string("Unsupported escape '\\") + e + "' (use \\d, \\w, \\s or [^...])";
+            return -1;
+        }
+        for (int ch = 0; ch < 256; ch++) {
+            bool in = (e == 'd' && isdigit(ch)) || (e == 's' && isspace(ch)) ||
+                      (e == 'w' && (isalnum(ch) || ch == '_'));
+            if (in) addPatternChar(p.nodes[node].chars, static_cast<unsigned char>(ch));
+        }
+        if (e != 'd' && e != 's' && e != 'w') addPatternChar(p.nodes[node].chars, static_cast<unsigned char>(e));
+    } else if (c == '*' || c == '+' || c == '?' || c == ')' || c == '|') {
+        p.error = string("Unexpected '") + c + "'";
+        return -1;
+    } else if (c == '^' || c == '$') {
+        p.error = string("Anchors are not supported, write '\\") + c + "' for the character";
+        return -1;
+    } else {
+        addPatternChar(p.nodes[node].chars, static_cast<unsigned char>(c));
+    }
+    return node;
+}
+
+int parsePatternRepeat(PatternParser& p) {
+    int node = parsePatternAtom(p);
+    while (node != -1 && p.pos < p.text.size()) {
+        char c = p.text[p.pos];
+        if (c == '*') node = addPatternNode(p, PATTERN_STAR, node);
+        else if (c == '+') node = addPatternNode(p, PATTERN_PLUS, node);
+        else if (c == '?') node = addPatternNode(p, PATTERN_OPTIONAL, node);
+        else break;
+        p.pos++;
+    }
+    return node;
+}
+
+int parsePatternConcat(PatternParser& p) {
+    int node = -1;
+    while (p.pos < p.text.size() && p.text[p.pos] != '|' && p.text[p.pos] != ')') {
+        int next = parsePatternRepeat(p);
+        if (next == -1) return -1;
+        node = (node == -1) ? next : addPatternNode(p, PATTERN_CONCAT, node, next);
+    }
+    return node == -1 ? addPatternNode(p, PATTERN_EMPTY) : node;
+}
+
+int parsePatternAlternation(PatternParser& p) {
+    int node = parsePatternConcat(p);
+    while (node != -1 && p.pos < p.text.size() && p.text[p.pos] == '|') {
+        p.pos++;
+        int right = parsePatternConcat(p);
+        if (right == -1) return -1;
+        node = addPatternNode(p, PATTERN_ALT, node, right);
+    }
+    return node;
+}
+
+// Literals that every match must contain: runs of single-character nodes in a
+// concatenation, plus whatever a '+' or group inside it requires
+void collectPatternLiterals(const vector<PatternNode>& nodes, int node, string& run, vector<string>& out) {
+    const PatternNode& n = nodes[node];
+    if (n.type == PATTERN_CONCAT) {
+        collectPatternLiterals(nodes, n.left, run, out);
+        collectPatternLiterals(nodes, n.right, run, out);
+        return;
+    }
+    if (n.type == PATTERN_CHARS && n.chars.count() == 1) {
+        for (int ch = 0; ch < 256; ch++) {
+            if (n.chars.test(ch)) run += static_cast<char>(ch);
+        }
+        return;
+    }
+
+    // Anything else breaks the current run of literal characters
+    if (run.size() >= 2) out.push_back(run);
+    run.clear();
+    if (n.type == PATTERN_PLUS) {
+        collectPatternLiterals(nodes, n.left, run, out);
+        if (run.size() >= 2) out.push_back(run);
+        run.clear();
+    }
+}
+
+struct NfaState {
+    bitset<256> chars;   // consuming edge to out
+    int out;
+    vector<int> epsilon;
+};
+
+// Thompson construction; returns (start, end) states of the fragment for node
+pair<int, int> buildNfa(const vector<PatternNode>& nodes, int node, vector<NfaState>& nfa) {
+    const PatternNode& n = nodes[node];
+    int start = static_cast<int>(nfa.size());
+    nfa.push_back(NfaState());
+    nfa.back().out = -1;
+    int end = static_cast<int>(nfa.size());
+    nfa.push_back(NfaState());
+    nfa.back().out = -1;
+
+    if (n.type == PATTERN_CHARS) {
+        nfa[start].chars = n.chars;
+        nfa[start].out = end;
+    } else if (n.type == PATTERN_EMPTY) {
+        nfa[start].epsilon.push_back(end);
+    } else if (n.type == PATTERN_CONCAT) {
+        pair<int, int> a = buildNfa(nodes, n.left, nfa);
+        pair<int, int> b = buildNfa(nodes, n.right, nfa);
+        nfa[start].epsilon.push_back(a.first);
+        nfa[a.second].epsilon.push_back(b.first);
+        nfa[b.second].epsilon.push_back(end);
+    } else if (n.type == PATTERN_ALT) {
+        pair<int, int> a = buildNfa(nodes, n.left, nfa);
+        pair<int, int> b = buildNfa(nodes, n.right, nfa);
+        nfa[start].epsilon.push_back(a.first);
+        nfa[start].epsilon.push_back(b.first);
+        nfa[a.second].epsilon.push_back(end);
+        nfa[b.second].epsilon.push_back(end);
+    } else {
+        pair<int, int> a = buildNfa(nodes, n.left, nfa);
+        nfa[start].epsilon.push_back(a.first);
+        nfa[a.second].epsilon.push_back(end);
+        if (n.type == PATTERN_STAR || n.type == PATTERN_OPTIONAL) nfa[start].epsilon.push_back(end);
+        if (n.type == PATTERN_STAR || n.type == PATTERN_PLUS) nfa[a.second].epsilon.push_back(a.first);
+    }
+    return make_pair(start, end);
+}
+
+void epsilonClosure(const vector<NfaState>& nfa, vector<int>& states) {
+    vector<bool> seen(nfa.size(), false);
+    for (size_t i = 0; i < states.size(); i++) seen[states[i]] = true;
+    for (size_t i = 0; i < states.size(); i++) {
+        const vector<int>& next = nfa[states[i]].epsilon;
+        for (size_t j = 0; j < next.size(); j++) {
+            if (!seen[next[j]]) {
+                seen[next[j]] = true;
+                states.push_back(next[j]);
+            }
+        }
+    }
+    sort(states.begin(), states.end());
+}
+
+// Globs become anchored regular expressions: * -> .*, ? -> ., [!...] -> [^...]
+string globToRegex(const string& glob) {
+    string regex;
+    for (size_t i = 0; i < glob.size(); i++) {
+        char c = glob[i];
+        if (c == '*') regex += ".*";
+        else if (c == '?') regex += '.';
+        else if (c == '[') {
+            size_t close = glob.find(']', i + 2);
+            if (close == string::npos) {
+                regex += "\\[";
+                continue;
+            }
+            string body = glob.substr(i + 1, close - i - 1);
+            if (!body.empty() && body[0] == '!') body[0] = '^';
+            regex += "[" + body + "]";
+            i = close;
+        } else if (string(".+()|\\^$").find(c) != string::npos) {
+            regex += '\\';
+            regex += c;
+        } else {
+            regex += c;
+        }
+    }
+    return regex;
+}
+
+bool compilePattern(const string& text, bool glob, CompiledPattern& out, string& error) {
+    PatternParser p;
+    p.text = glob ? globToRegex(text) : text;
+    p.pos = 0;
+
+    int root = parsePatternAlternation(p);
+    if (root != -1 && p.pos < p.text.size()) p.error = "Unexpected ')'";
+    if (root == -1 || !p.error.empty()) {
+        error = p.error;
+        return false;
+    }
+
+    out.anchored = glob;
+    out.literals.clear();
+    string run;
+    collectPatternLiterals(p.nodes, root, run, out.literals);
+    if (run.size() >= 2) out.literals.push_back(run);
+
+    vector<NfaState> nfa;
+    pair<int, int> fragment = buildNfa(p.nodes, root, nfa);
+    int start = fragment.first;
+    if (!glob) {
+        // Searching anywhere in the text: a start state that may skip any character first
+        NfaState skip;
+        skip.chars.set();
+        skip.out = static_cast<int>(nfa.size());
+        skip.epsilon.push_back(fragment.first);
+        nfa.push_back(skip);
+        start = skip.out;
+    }
+
+    // Subset construction
+    map<vector<int>, int> dfaIds;
+    vector<vector<int> > dfaSets;
+    vector<int> initial(1, start);
+    epsilonClosure(nfa, initial);
+    dfaIds[initial] = 0;
+    dfaSets.push_back(initial);
+    out.transitions.clear();
+    out.accepting.clear();
+
+    for (size_t d = 0; d < dfaSets.size(); d++) {
+        out.transitions.resize((d + 1) * 256, -1);
+        out.accepting.push_back(binary_search(dfaSets[d].begin(), dfaSets[d].end(), fragment.second));
+
+        for (int c = 0; c < 256; c++) {
+            if (c >= 'A' && c <= 'Z') continue; // text is lower-cased before matching
+            vector<int> next;
+            for (size_t s = 0; s < dfaSets[d].size(); s++) {
+                const NfaState& state = nfa[dfaSets[d][s]];
+                if (state.out != -1 && state.chars.test(c)) next.push_back(state.out);
+            }
+            if (next.empty()) continue;
+            epsilonClosure(nfa, next);
+
+            map<vector<int>, int>::iterator it = dfaIds.find(next);
+            int target;
+            if (it != dfaIds.end()) {
+                target = it->second;
+            } else {
+                if (static_cast<int>(dfaSets.size()) >= PATTERN_MAX_STATES) {
+                    error = "Pattern is too complex";
+                    return false;
+                }
+                target = static_cast<int>(dfaSets.size());
+                dfaIds[next] = target;
+                dfaSets.push_back(next);
+            }
+            out.transitions[d * 256 + c] = target;
+        }
+    }
+    return true;
+}
+
+bool patternMatches(const CompiledPattern& pattern, const string& field) {
+    // Cheap substring checks first; the automaton only sees fields that pass them
+    for (size_t i = 0; i < pattern.literals.size(); i++) {
+        if (!containsSubstring(field, pattern.literals[i])) return false;
+    }
+
+    int state = 0;
+    for (size_t i = 0; i < field.size(); i++) {
+        if (!pattern.anchored && pattern.accepting[state]) return true;
+        unsigned char c = static_cast<unsigned char>(tolower(static_cast<unsigned char>(field[i])));
+        state = pattern.transitions[state * 256 + c];
+        if (state == -1) return false;
+    }
+    return pattern.accepting[state];
+}
+
+
+
+
+
+
+
+// Result Cursors
+// Searches hand back a cursor instead of filling a store-sized array. Matches are
+// produced one at a time on request, so showing the first page of a broad search
+// only examines as many items as it takes to fill that page.
+
+struct ResultCursor {
+    Item* items;                      // only read when predicates must be verified
+    int itemCount;
+    bool allSlots;                    // true = every slot is a candidate
+    const Bitmap* candidates;         // index bitmap to walk, NULL = ownedCandidates
+    Bitmap ownedCandidates;
+    vector<QueryPredicate> verify;    // all must hold for a candidate to be returned
+    bool verifyAny;                   // true = one of them is enough (OR queries)
+    vector<CompiledPattern> patterns; // each must match the name or the description
+    Bitmap accepted;                  // returned without verifying, e.g. synonym hits
+    bool useList;                     // true = return the precomputed list instead
+    vector<int> list;
+    bool useBuckets;                  // true = walk date buckets oldest first
+    map<int, Bitmap>::const_iterator bucket, bucketEnd;
+    string fuzzyName;                 // non-empty = return exact-distance 0 names, then the rest
+    int fuzzyMaxEdits;
+    vector<pair<int, int> > fuzzyLater; // (distance, slot) of the near misses found so far
+    int position;                     // next slot (or list entry) to look at
+};
+
+ResultCursor emptyCursor() {
+    ResultCursor cursor;
+    cursor.items = NULL;
+    cursor.itemCount = 0;
+    cursor.allSlots = false;
+    cursor.candidates = NULL;
+    cursor.verifyAny = false;
+    cursor.useList = false;
+    cursor.useBuckets = false;
+    cursor.fuzzyMaxEdits = 0;
+    cursor.position = 0;
+    return cursor;
+}
+
+QueryPredicate makePredicate(int field, int op, const string& value) {
+    QueryPredicate pred;
+    pred.field = field;
+    pred.op = op;
+    pred.value = value;
+    pred.date = 0;
+    pred.estimate = 0;
+    pred.indexed = false;
+    return pred;
+}
+
+// Every item whose field contains value
+ResultCursor scanCursor(Item items[], int itemCount, int field, const string& value) {
+    ResultCursor cursor = emptyCursor();
+    cursor.items = items;
+    cursor.itemCount = itemCount;
+    cursor.allSlots = true;
+    cursor.verify.push_back(makePredicate(field, OP_CONTAINS, value));
+    return cursor;
+}
+
+// Walks an index bitmap in place; the index must not change while the cursor is used
+ResultCursor bitmapCursor(const Bitmap& bm) {
+    ResultCursor cursor = emptyCursor();
+    cursor.candidates = &bm;
+    return cursor;
+}
+
+ResultCursor ownedBitmapCursor(const Bitmap& bm) {
+    ResultCursor cursor = emptyCursor();
+    cursor.ownedCandidates = bm;
+    return cursor;
+}
+
+ResultCursor listCursor(const vector<int>& slots) {
+    ResultCursor cursor = emptyCursor();
+    cursor.useList = true;
+    cursor.list = slots;
+    return cursor;
+}
+
+ResultCursor bucketCursor(map<int, Bitmap>::const_iterator from, map<int, Bitmap>::const_iterator to) {
+    ResultCursor cursor = emptyCursor();
+    cursor.useBuckets = true;
+    cursor.bucket = from;
+    cursor.bucketEnd = to;
+    return cursor;
+}
+
+int fuzzyDistance(const string& pattern, const string& text);
+
+bool cursorNext(ResultCursor& cursor, int& slot) {
+    if (cursor.useList) {
+        if (cursor.position >= static_cast<int>(cursor.list.size())) return false;
+        slot = cursor.list[cursor.position++];
+        return true;
+    }
+
+    if (cursor.useBuckets) {
+        while (cursor.bucket != cursor.bucketEnd) {
+            int next = bitmapNextSlot(cursor.bucket->second, cursor.position);
+            if (next != -1) {
+                cursor.position = next + 1;
+                slot = next;
+                return true;
+            }
+            ++cursor.bucket;
+            cursor.position = 0;
+        }
+        return false;
+    }
+
+    const Bitmap& candidates = cursor.candidates ? *cursor.candidates : cursor.ownedCandidates;
+    while (true) {
+        int next;
+        if (cursor.allSlots) next = cursor.position < cursor.itemCount ? cursor.position : -1;
+        else next = bitmapNextSlot(candidates, cursor.position);
+        if (next == -1 && !cursor.fuzzyName.empty()) {
+            // Every candidate is checked: the names with typos follow, fewest first
+            stable_sort(cursor.fuzzyLater.begin(), cursor.fuzzyLater.end());
+            vector<int> slots(cursor.fuzzyLater.size());
+            for (size_t i = 0; i < slots.size(); i++) slots[i] = cursor.fuzzyLater[i].second;
+            cursor = listCursor(slots);
+            return cursorNext(cursor, slot);
+        }
+        if (next == -1) return false;
+        cursor.position = next + 1;
+
+        if (bitmapContains(cursor.accepted, next)) {
+            slot = next;
+            return true;
+        }
+
+        bool keep = !cursor.verifyAny || cursor.verify.empty();
+        for (size_t p = 0; p < cursor.verify.size() && keep != cursor.verifyAny; p++)
+            keep = itemMatchesPredicate(cursor.items[next], cursor.verify[p]);
+        if (keep && !cursor.fuzzyName.empty()) {
+            int distance = fuzzyDistance(cursor.fuzzyName, toLowerCase(cursor.items[next].name));
+            if (distance > 0 && distance <= cursor.fuzzyMaxEdits) cursor.fuzzyLater.push_back(make_pair(distance, next));
+            keep = distance == 0;
+        }
+        for (size_t p = 0; keep && p < cursor.patterns.size(); p++)
+            keep = patternMatches(cursor.patterns[p], cursor.items[next].name) ||
+                   patternMatches(cursor.patterns[p], cursor.items[next].description);
+        if (keep) {
+            slot = next;
+            return true;
+        }
+    }
+}
+
+// Reads the rest of a cursor into results, returns how many were written
+int drainCursor(ResultCursor& cursor, int results[]) {
+    int count = 0, slot;
+    while (cursorNext(cursor, slot)) results[count++] = slot;
+    return count;
+}
+
+// Lazy cursor for a planned query. Conjunctions intersect the indexed predicates up
+// front and verify the rest per candidate as the cursor advances. Disjunctions
+// accept the union of the indexed predicates as it comes and check any other
+// slot against the unindexed ones.
+ResultCursor openQueryCursor(Item items[], int itemCount, const ItemIndex& index, const Query& query) {
+    ResultCursor cursor = emptyCursor();
+    cursor.items = items;
+    cursor.itemCount = itemCount;
+
+    if (query.anyOf) {
+        for (size_t i = 0; i < query.predicates.size(); i++) {
+            Bitmap bm;
+            if (predicateBitmap(index, query.predicates[i], bm)) cursor.ownedCandidates = bitmapOr(cursor.ownedCandidates, bm);
+            else cursor.verify.push_back(query.predicates[i]);
+        }
+        if (!cursor.verify.empty()) { // any slot may qualify, the union needs no check
+            cursor.allSlots = true;
+            cursor.verifyAny = true;
+            cursor.accepted.containers.swap(cursor.ownedCandidates.containers);
+        }
+        return cursor;
+    }
+
+    cursor.allSlots = true;
+    bool haveCandidates = false;
+    for (size_t i = 0; i < query.predicates.size(); i++) {
+        Bitmap bm;
+        if (predicateBitmap(index, query.predicates[i], bm)) {
+            cursor.ownedCandidates = haveCandidates ? bitmapAnd(cursor.ownedCandidates, bm) : bm;
+            haveCandidates = true;
+            cursor.allSlots = false;
+        } else {
+            cursor.verify.push_back(query.predicates[i]);
+        }
+    }
+    return cursor;
+}
+
+
+
+
+
+
+
+const int RESULTS_PAGE_SIZE = 5;
+
+// Shows a cursor one page at a time, pulling only what the pages need.
+// Returns true when the cursor was read to the end; seen then holds every result.
+bool displayResultPages(Item items[], ResultCursor& cursor, const ItemIndex& index, vector<int>& seen) {
+    bool exhausted = false;
+    int page = 0;
+
+    while (true) {
+        // One extra result tells us whether a next page exists
+        size_t needed = static_cast<size_t>((page + 1) * RESULTS_PAGE_SIZE + 1);
+        int slot;
+        while (!exhausted && seen.size() < needed) {
+            if (cursorNext(cursor, slot)) seen.push_back(slot);
+            else exhausted = true;
+        }
+
+        if (seen.empty()) {
+            cout << "No items found matching criteria.\n";
+            return true;
+        }
+
+        // Everything fits on one page: print it like before, facets included
+        if (page == 0 && exhausted && seen.size() <= static_cast<size_t>(RESULTS_PAGE_SIZE)) {
+            displayResults(items, &seen[0], static_cast<int>(seen.size()), &index);
+            return true;
+        }
+
+        size_t first = static_cast<size_t>(page * RESULTS_PAGE_SIZE);
+        size_t last = min(first + RESULTS_PAGE_SIZE, seen.size());
+        bool hasNext = last < seen.size();
+
+        cout << "\n===========================================================================================================================\n";
+        cout << "\n========== SEARCH / FILTER RESULTS " << first + 1 << "-" << last;
+        if (exhausted) cout << " of " << seen.size();
+        else cout << " (more available)";
+        cout << " ==========\n";
+        for (size_t i = first; i < last; i++)
+            displayResultRow(items[seen[i]]);
+
+        string choice;
+        cout << (hasNext ? "[N]ext page  " : "") << (page > 0 ? "[P]revious page  " : "")
+             << "[F]acet counts  [Q]uit: ";
+        getline(cin, choice);
+        char c = choice.empty() ? 'q' : static_cast<char>(tolower(static_cast<unsigned char>(choice[0])));
+
+        if (c == 'n' && hasNext) {
+            page++;
+        } else if (c == 'p' && page > 0) {
+            page--;
+        } else if (c == 'f') {
+            // Counting needs every result, so this is the one place a broad search is read in full
+            while (!exhausted) {
+                if (cursorNext(cursor, slot)) seen.push_back(slot);
+                else exhausted = true;
+            }
+            displayFacets(index, &seen[0], static_cast<int>(seen.size()));
+        } else if (c == 'q') {
+            return exhausted;
+        } else {
+            cout << "Invalid choice.\n";
+        }
+    }
+}
+
+
+
+
+
+
+//Search & Filter Functions
+
+ResultCursor searchByName(Item items[], int itemCount, const string& name) {
+    return scanCursor(items, itemCount, FIELD_NAME, name);
+}
+
+ResultCursor searchByCategory(const ItemIndex& index, const string& category) {
+    Bitmap hits;
+    for (int c = 0; c < CATEGORY_COUNT; c++) {
+        if (containsSubstring(CATEGORIES[c], category))
+            hits = bitmapOr(hits, index.categorySlots[c]);
+    }
+    return ownedBitmapCursor(hits);
+}
+
+// Slots whose description has every normalized term of text, in any order
+Bitmap descriptionTermSlots(const ItemIndex& index, const string& text) {
+    vector<int> ids = sortedTermSet(knownTermsOf(index.normalizer, text));
+    Bitmap hits;
+    for (size_t t = 0; t < ids.size(); t++) {
+        unordered_map<int, vector<TermPosting> >::const_iterator it = index.descriptionTerms.find(ids[t]);
+        if (it == index.descriptionTerms.end()) return Bitmap(); // also catches -1, an unknown word
+        Bitmap slots;
+        for (size_t p = 0; p < it->second.size(); p++) bitmapAdd(slots, it->second[p].slot);
+        hits = (t == 0) ? slots : bitmapAnd(hits, slots);
+    }
+    return hits;
+}
+
+// The text as a substring, or its words after normalization ("mobile" finds "phone")
+ResultCursor searchByDescription(Item items[], int itemCount, const ItemIndex& index, const string& description) {
+    ResultCursor cursor = scanCursor(items, itemCount, FIELD_DESCRIPTION, description);
+    cursor.accepted = descriptionTermSlots(index, description);
+    return cursor;
+}
+
+// The text as a substring, or when it names a place in the hierarchy,
+// every item filed anywhere below it ("Library" finds "Library, Reading Room")
+ResultCursor searchByLocation(Item items[], int itemCount, const ItemIndex& index, const string& location) {
+    ResultCursor cursor = scanCursor(items, itemCount, FIELD_LOCATION, location);
+    int node = resolveLocation(index.locations, location);
+    if (node != -1) {
+        map<int, Bitmap>::const_iterator from = index.locationBuckets.lower_bound(index.locations.nodes[node].enter);
+        map<int, Bitmap>::const_iterator to = index.locationBuckets.upper_bound(index.locations.nodes[node].exit);
+        cursor.accepted = bucketUnion(from, to);
+    }
+    return cursor;
+}
+
+
+ResultCursor searchByDate(const ItemIndex& index, int date) {
+    map<int, Bitmap>::const_iterator bucket = index.dateBuckets.find(date);
+    if (bucket == index.dateBuckets.end()) return emptyCursor();
+
+    return bitmapCursor(bucket->second);
+}
+
+// Inclusive range, results come out oldest date first
+ResultCursor searchByDateRange(const ItemIndex& index, int fromDate, int toDate) {
+    return bucketCursor(index.dateBuckets.lower_bound(fromDate), index.dateBuckets.upper_bound(toDate));
+}
+
+ResultCursor searchByStatus(const ItemIndex& index, const string& status) {
+    int s = statusIndexOf(status);
+    if (s == -1) return emptyCursor();
+
+    // Status matches AND item is unmatched
+    return ownedBitmapCursor(bitmapAnd(index.statusSlots[s], index.matchedSlots[0]));
+}
+
+// Owner/finder names that sound like the query; every word of the query must match a word of the name
+ResultCursor searchByPerson(const ItemIndex& index, const string& person) {
+    vector<string> keys = phoneticKeysOf(person);
+    if (keys.empty()) return emptyCursor();
+
+    Bitmap hits;
+    for (size_t i = 0; i < keys.size(); i++) {
+        unordered_map<string, Bitmap>::const_iterator it = index.personKeys.find(keys[i]);
+        if (it == index.personKeys.end()) return emptyCursor();
+        hits = (i == 0) ? it->second : bitmapAnd(hits, it->second);
+    }
+    return ownedBitmapCursor(hits);
+}
+
+// Unclaimed items whose owner/finder contact is the given phone number or email
+ResultCursor searchOpenByContact(const ItemIndex& index, const string& contact) {
+    unordered_map<string, Bitmap>::const_iterator it = index.contactSlots.find(normalizeContact(contact));
+    if (it == index.contactSlots.end()) return emptyCursor();
+
+    return ownedBitmapCursor(bitmapAnd(it->second, index.claimedSlots[0]));
+}
+
+// Names or descriptions matching a compiled regex/glob
+ResultCursor searchByPattern(Item items[], int itemCount, const CompiledPattern& pattern) {
+    ResultCursor cursor = emptyCursor();
+    cursor.items = items;
+    cursor.itemCount = itemCount;
+    cursor.allSlots = true;
+    cursor.patterns.push_back(pattern);
+    return cursor;
+}
+
+ResultCursor filterByMatched(const ItemIndex& index, int matchedValue) {
+    return bitmapCursor(index.matchedSlots[matchedValue ? 1 : 0]);
+}
+
+ResultCursor filterByClaimed(const ItemIndex& index, int claimedValue) {
+    return bitmapCursor(index.claimedSlots[claimedValue ? 1 : 0]);
+}
+
+
+
+
+
+
+
+// Fuzzy Search
+// Typo-tolerant name search. Candidates are narrowed with the bigram index
+// (q-gram lemma: a match with k edits keeps at least m - 1 - 2k of the
+// pattern's m - 1 bigrams), then checked with Myers' bit-parallel
+// approximate matcher, which finds the best substring edit distance in one
+// pass of 64-bit word operations per text character.
+
+// Smallest edit distance between pattern and any substring of text (both lower-case)
+int fuzzyDistance(const string& pattern, const string& text) {
+    int m = static_cast<int>(pattern.size());
+    if (m == 0) return 0;
+
+    if (m > 64) {
+        // Too long for one machine word: plain dynamic programming
+        vector<int> column(m + 1);
+        for (int i = 0; i <= m; i++) column[i] = i;
+        int best = m;
+        for (size_t j = 0; j < text.size(); j++) {
+            int diagonal = 0; // row 0 is free, a match may start anywhere
+            for (int i = 1; i <= m; i++) {
+                int above = column[i];
+                int cost = (pattern[i - 1] == text[j]) ? 0 : 1;
+                column[i] = min(min(column[i] + 1, column[i - 1] + 1), diagonal + cost);
+                diagonal = above;
+            }
+            best = min(best, column[m]);
+        }
+        return best;
+    }
+
+    unsigned long long peq[256] = {0};
+    for (int i = 0; i < m; i++)
+        peq[static_cast<unsigned char>(pattern[i])] |= 1ULL << i;
+
+    unsigned long long pv = (m == 64) ? ~0ULL : ((1ULL << m) - 1);
+    unsigned long long mv = 0;
+    unsigned long long high = 1ULL << (m - 1);
+    int score = m;
+    int best = m;
+
+    for (size_t j = 0; j < text.size(); j++) {
+        unsigned long long eq = peq[static_cast<unsigned char>(text[j])];
+        unsigned long long xv = eq | mv;
+        unsigned long long xh = (((eq & pv) + pv) ^ pv) | eq;
+        unsigned long long ph = mv | ~(xh | pv);
+        unsigned long long mh = pv & xh;
+
+        if (ph & high) score++;
+        else if (mh & high) score--;
+
+        ph <<= 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        if (score < best) best = score;
+    }
+    return best;
+}
+
+// Results are ordered best match first, then by slot. The cursor verifies
+// candidates as it advances: names with no typo come out as they are found,
+// the others are held back (only those, not the whole store) until the
+// candidates run out. usePrefilter = false checks every item (for benchmarks).
+ResultCursor searchByNameFuzzy(Item items[], int itemCount, const ItemIndex& index, const string& name,
+                               int maxEdits, bool usePrefilter = true) {
+    ResultCursor cursor = emptyCursor();
+    cursor.items = items;
+    cursor.itemCount = itemCount;
+    cursor.fuzzyName = toLowerCase(name);
+    cursor.fuzzyMaxEdits = maxEdits;
+    int m = static_cast<int>(cursor.fuzzyName.size());
+    int needed = (m - 1) - 2 * maxEdits; // bigrams a true match must share
+
+    if (!usePrefilter || needed <= 0) {
+        cursor.allSlots = true;
+        return cursor;
+    }
+
+    // Gather the posting lists of the pattern's bigrams (each once per occurrence);
+    // after sorting, a slot shares as many bigrams as it appears in a row
+    vector<int> postings;
+    for (int i = 0; i + 1 < m; i++) {
+        int gram = (static_cast<unsigned char>(cursor.fuzzyName[i]) << 8) | static_cast<unsigned char>(cursor.fuzzyName[i + 1]);
+        unordered_map<int, Bitmap>::const_iterator it = index.nameBigrams.find(gram);
+        if (it == index.nameBigrams.end()) continue;
+
+        size_t start = postings.size();
+        postings.resize(start + bitmapCardinality(it->second));
+        bitmapToArray(it->second, &postings[start]);
+    }
+    sort(postings.begin(), postings.end());
+    for (size_t i = 0; i < postings.size();) {
+        size_t run = i;
+        while (run < postings.size() && postings[run] == postings[i]) run++;
+        if (static_cast<int>(run - i) >= needed) bitmapAdd(cursor.ownedCandidates, postings[i]);
+        i = run;
+    }
+    return cursor;
+}
+
+
+
+
+
+
+
+// Phrase Search
+// Exact and proximity phrases over descriptions, answered from the positional
+// index alone: "black leather" needs the words next to each other in that
+// order, "black NEAR/2 leather" needs them at most two words apart either way.
+// Posting lists are intersected by slot starting from the rarest term, and
+// positions are only compared for slots that contain every term.
+
+struct PhraseQuery {
+    vector<string> terms;
+    vector<int> gaps;   // gaps[i] links terms[i] and terms[i + 1]: 0 = next word, k = NEAR/k
+};
+
+bool parsePhrase(const string& text, PhraseQuery& phrase, string& error) {
+    phrase.terms.clear();
+    phrase.gaps.clear();
+    int pendingGap = 0;
+    bool afterNear = false;
+
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find(' ', pos);
+        if (end == string::npos) end = text.size();
+        string word = text.substr(pos, end - pos);
+        pos = end + 1;
+        if (word.empty()) continue;
+
+        string lower = toLowerCase(word);
+        if (lower.compare(0, 5, "near/") == 0) {
+            int k = atoi(lower.c_str() + 5);
+            if (phrase.terms.empty() || afterNear || k < 1 || k > 50) {
+                error = "NEAR/k needs a word on each side and 1 <= k <= 50";
+                return false;
+            }
+            pendingGap = k;
+            afterNear = true;
+            continue;
+        }
+
+        vector<string> tokens = tokensOf(word);
+        for (size_t i = 0; i < tokens.size(); i++) {
+            if (!phrase.terms.empty()) phrase.gaps.push_back(i == 0 ? pendingGap : 0);
+            phrase.terms.push_back(tokens[i]);
+        }
+        if (!tokens.empty()) {
+            pendingGap = 0;
+            afterNear = false;
+        }
+    }
+
+    if (afterNear) {
+        error = "NEAR/k needs a word on each side and 1 <= k <= 50";
+        return false;
+    }
+    if (phrase.terms.empty()) {
+        error = "Enter at least one word";
+        return false;
+    }
+    return true;
+}
+
+// First posting at or after from with slot >= slot, by galloping then binary search
+size_t advancePosting(const vector<TermPosting>& postings, size_t from, int slot) {
+    size_t step = 1;
+    size_t hi = from;
+    while (hi < postings.size() && postings[hi].slot < slot) {
+        from = hi + 1;
+        hi += step;
+        step *= 2;
+    }
+    if (hi > postings.size()) hi = postings.size();
+    return lower_bound(postings.begin() + from, postings.begin() + hi, slot, postingBefore) - postings.begin();
+}
+
+// Positions chain check within one description
+bool phraseMatchesAt(const PhraseQuery& phrase, const vector<const TermPosting*>& hits) {
+    vector<int> ends = hits[0]->positions;
+    for (size_t t = 1; t < hits.size(); t++) {
+        int gap = phrase.gaps[t - 1];
+        const vector<int>& positions = hits[t]->positions;
+        vector<int> next;
+
+        for (size_t i = 0; i < positions.size(); i++) {
+            int p = positions[i];
+            vector<int>::const_iterator e = lower_bound(ends.begin(), ends.end(), gap == 0 ? p - 1 : p - gap);
+            bool linked = false;
+            for (; e != ends.end() && !linked; ++e) {
+                if (gap == 0) {
+                    linked = (*e == p - 1);
+                    break;
+                }
+                if (*e > p + gap) break;
+                linked = (*e != p);
+            }
+            if (linked) next.push_back(p);
+        }
+
+        if (next.empty()) return false;
+        ends.swap(next);
+    }
+    return true;
+}
+
+ResultCursor searchByPhrase(const ItemIndex& index, const PhraseQuery& phrase) {
+    vector<const vector<TermPosting>*> lists;
+    for (size_t t = 0; t < phrase.terms.size(); t++) {
+        unordered_map<int, vector<TermPosting> >::const_iterator it = index.descriptionTerms.find(knownTermID(index.normalizer, phrase.terms[t]));
+        if (it == index.descriptionTerms.end()) return emptyCursor();
+        lists.push_back(&it->second);
+    }
+
+    // Drive the intersection from the shortest posting list
+    size_t rarest = 0;
+    for (size_t t = 1; t < lists.size(); t++) {
+        if (lists[t]->size() < lists[rarest]->size()) rarest = t;
+    }
+
+    vector<size_t> cursors(lists.size(), 0);
+    vector<const TermPosting*> hits(lists.size());
+    vector<int> slots;
+
+    for (size_t r = 0; r < lists[rarest]->size(); r++) {
+        int slot = (*lists[rarest])[r].slot;
+        bool everyTerm = true;
+        for (size_t t = 0; t < lists.size() && everyTerm; t++) {
+            cursors[t] = advancePosting(*lists[t], cursors[t], slot);
+            everyTerm = cursors[t] < lists[t]->size() && (*lists[t])[cursors[t]].slot == slot;
+            if (everyTerm) hits[t] = &(*lists[t])[cursors[t]];
+        }
+        if (everyTerm && phraseMatchesAt(phrase, hits)) slots.push_back(slot);
+    }
+    return listCursor(slots);
+}
+
+
+
+
+
+
+
+// Similar Items
+// Near-duplicate descriptions through the LSH buckets: only items sharing a
+// band with the query are looked at, then ranked by estimated similarity.
+
+// Every slot sharing at least one LSH bucket with sig
+Bitmap similarDescriptions(const ItemIndex& index, const MinHashSignature& sig) {
+    Bitmap candidates;
+    if (sig.empty) return candidates;
+    for (int b = 0; b < MINHASH_BANDS; b++) {
+        unordered_map<unsigned long long, Bitmap>::const_iterator it = index.lshBuckets.find(bandKeyOf(sig, b));
+        if (it != index.lshBuckets.end()) candidates = bitmapOr(candidates, it->second);
+    }
+    return candidates;
+}
+
+bool moreSimilar(const pair<double, int>& a, const pair<double, int>& b) {
+    return a.first != b.first ? a.first > b.first : a.second < b.second;
+}
+
+// Items whose description is at least minSimilarity alike, most similar first; skipSlot = -1 keeps all
+ResultCursor searchSimilarItems(const ItemIndex& index, const MinHashSignature& sig, double minSimilarity, int skipSlot) {
+    Bitmap candidates = similarDescriptions(index, sig);
+    vector<pair<double, int> > ranked;
+    for (int slot = bitmapNextSlot(candidates, 0); slot != -1; slot = bitmapNextSlot(candidates, slot + 1)) {
+        if (slot == skipSlot) continue;
+        double similarity = minHashSimilarity(sig, index.signatures[slot]);
+        if (similarity >= minSimilarity) ranked.push_back(make_pair(similarity, slot));
+    }
+    sort(ranked.begin(), ranked.end(), moreSimilar);
+
+    vector<int> slots;
+    for (size_t i = 0; i < ranked.size(); i++) slots.push_back(ranked[i].second);
+    return listCursor(slots);
+}
+
+
+
+
+
+
+
+// Ranked Search
+// Descriptions ranked by TF-IDF cosine similarity to a query, best first.
+// The top k are found WAND-style: the posting lists of the query terms are
+// walked together in slot order, and an item is only scored in full when the
+// terms it can contain could still lift it above the current k-th score.
+// Items that cannot are skipped, along with their postings, by galloping.
+
+// TF-IDF weights of a description's words; document frequencies come from the positional index
+struct TermVector {
+    unordered_map<int, double> weights;
+    double norm;
+
+    TermVector() : norm(0.0) {}
+};
+
+TermVector descriptionVector(const ItemIndex& index, int itemCount, const vector<int>& terms) {
+    TermVector vec;
+    for (size_t i = 0; i < terms.size(); i++) {
+        if (terms[i] != -1) vec.weights[terms[i]] += 1.0;
+    }
+
+    for (unordered_map<int, double>::iterator it = vec.weights.begin(); it != vec.weights.end(); ++it) {
+        unordered_map<int, vector<TermPosting> >::const_iterator term = index.descriptionTerms.find(it->first);
+        double df = (term == index.descriptionTerms.end()) ? 0.0 : static_cast<double>(term->second.size());
+        it->second *= log((itemCount + 1.0) / (df + 1.0)) + 1.0;
+        vec.norm += it->second * it->second;
+    }
+    vec.norm = sqrt(vec.norm);
+    return vec;
+}
+
+double termCosine(const TermVector& a, const TermVector& b) {
+    if (a.norm == 0.0 || b.norm == 0.0) return 0.0;
+    const TermVector& small = (a.weights.size() < b.weights.size()) ? a : b;
+    const TermVector& large = (a.weights.size() < b.weights.size()) ? b : a;
+    double dot = 0.0;
+    for (unordered_map<int, double>::const_iterator it = small.weights.begin(); it != small.weights.end(); ++it) {
+        unordered_map<int, double>::const_iterator other = large.weights.find(it->first);
+        if (other != large.weights.end()) dot += it->second * other->second;
+    }
+    return dot / (a.norm * b.norm);
+}
+
+// Upper bound of termCosine(query, d) knowing only which query terms d has:
+// by Cauchy-Schwarz the shared terms give at most |query restricted to them| / |query|,
+// however the rest of d is weighted. terms may repeat.
+double cosineBound(const TermVector& query, const vector<int>& terms) {
+    if (query.norm == 0.0) return 0.0;
+    vector<int> shared;
+    for (size_t i = 0; i < terms.size(); i++) {
+        if (query.weights.count(terms[i])) shared.push_back(terms[i]);
+    }
+    sort(shared.begin(), shared.end());
+    shared.erase(unique(shared.begin(), shared.end()), shared.end());
+
+    double sum = 0.0;
+    for (size_t i = 0; i < shared.size(); i++) {
+        double w = query.weights.find(shared[i])->second;
+        sum += w * w;
+    }
+    return min(1.0, sqrt(sum) / query.norm);
+}
+
+// Work done by a pruned top-k search
+struct PruneStats {
+    long scored;           // candidates scored in full
+    long skipped;          // match candidates ruled out by their bound
+    long postingsRead;     // postings stepped over one at a time
+    long postingsSkipped;  // postings jumped over
+
+    PruneStats() : scored(0), skipped(0), postingsRead(0), postingsSkipped(0) {}
+};
+
+struct WandList {
+    const vector<TermPosting>* postings;
+    size_t position;
+    double bound;          // squared share of the query norm held by this term
+
+    int slot() const { return position < postings->size() ? (*postings)[position].slot : INT_MAX; }
+};
+
+bool wandListBefore(const WandList& a, const WandList& b) {
+    return a.slot() < b.slot();
+}
+
+const int RANKED_RESULT_LIMIT = 10;
+
+// Up to k slots whose description is most like text, best first. usePruning = false
+// scores every item that has a query term (for benchmarks).
+ResultCursor searchRanked(const ItemIndex& index, int itemCount, const string& text, int k,
+                          PruneStats& stats, bool usePruning = true) {
+    TermVector query = descriptionVector(index, itemCount, knownTermsOf(index.normalizer, text));
+    vector<WandList> lists;
+    for (unordered_map<int, double>::const_iterator it = query.weights.begin(); it != query.weights.end(); ++it) {
+        // Name and location words share the dictionary but may have no description postings
+        unordered_map<int, vector<TermPosting> >::const_iterator term = index.descriptionTerms.find(it->first);
+        if (term == index.descriptionTerms.end()) continue;
+        WandList list;
+        list.postings = &term->second;
+        list.position = 0;
+        list.bound = (it->second * it->second) / (query.norm * query.norm);
+        lists.push_back(list);
+    }
+
+    // Min-heap (by moreSimilar) holding the best k so far
+    vector<pair<double, int> > heap;
+    while (k > 0 && !lists.empty()) {
+        sort(lists.begin(), lists.end(), wandListBefore);
+
+        // Pivot: first list at which the terms so far could beat the k-th score
+        double threshold = (usePruning && static_cast<int>(heap.size()) == k) ? heap.front().first : -1.0;
+        double reachable = 0.0;
+        int pivot = -1;
+        for (size_t i = 0; i < lists.size() && lists[i].slot() != INT_MAX; i++) {
+            reachable += lists[i].bound;
+            if (sqrt(min(1.0, reachable)) > threshold) {
+                pivot = static_cast<int>(i);
+                break;
+            }
+        }
+        if (pivot == -1) break;
+        int pivotSlot = lists[pivot].slot();
+
+        if (lists[0].slot() == pivotSlot) {
+            pair<double, int> hit(termCosine(query, descriptionVector(index, itemCount, index.itemTerms[pivotSlot].description)), pivotSlot);
+            stats.scored++;
+            if (static_cast<int>(heap.size()) < k) {
+                heap.push_back(hit);
+                push_heap(heap.begin(), heap.end(), moreSimilar);
+            } else if (moreSimilar(hit, heap.front())) {
+                pop_heap(heap.begin(), heap.end(), moreSimilar);
+                heap.back() = hit;
+                push_heap(heap.begin(), heap.end(), moreSimilar);
+            }
+            for (size_t i = 0; i < lists.size() && lists[i].slot() == pivotSlot; i++) {
+                lists[i].position++;
+                stats.postingsRead++;
+            }
+        } else {
+            // No slot before the pivot can make the top k: jump those lists ahead
+            for (int i = 0; i < pivot; i++) {
+                size_t from = lists[i].position;
+                lists[i].position = advancePosting(*lists[i].postings, from, pivotSlot);
+                stats.postingsSkipped += static_cast<long>(lists[i].position - from);
+            }
+        }
+    }
+
+    sort_heap(heap.begin(), heap.end(), moreSimilar);
+    vector<int> slots;
+    for (size_t i = 0; i < heap.size(); i++) {
+        if (heap[i].first > 0.0) slots.push_back(heap[i].second);
+    }
+    return listCursor(slots);
+}
+
+
+
+
+
+
+
+// Query Result Cache
+// Remembers the slots returned for recent queries. Each entry is tagged with the
+// index epoch it was computed at; any add, update, delete, match or claim bumps
+// the epoch, so an entry is only reused while the data is unchanged.
+
+const int QUERY_CACHE_SIZE = 32;
+
+struct CachedQuery {
+    string key;
+    unsigned long epoch;
+    unsigned long lastUsed;
+    vector<int> slots;
+};
+
+struct QueryCache {
+    vector<CachedQuery> entries;
+    unsigned long clock;
+    unsigned long hits;
+    unsigned long misses;
+
+    QueryCache() : clock(0), hits(0), misses(0) {}
+};
+
+bool cacheLookup(QueryCache& cache, const string& key, unsigned long epoch, vector<int>& slots) {
+    for (size_t i = 0; i < cache.entries.size(); i++) {
+        CachedQuery& entry = cache.entries[i];
+        if (entry.key == key && entry.epoch == epoch) {
+            entry.lastUsed = ++cache.clock;
+            slots = entry.slots;
+            cache.hits++;
+            return true;
+        }
+    }
+    cache.misses++;
+    return false;
+}
+
+void cacheStore(QueryCache& cache, const string& key, unsigned long epoch, const vector<int>& slots) {
+    // Reuse the slot of the same key, otherwise a stale entry, otherwise the least recently used
+    size_t victim = cache.entries.size();
+    for (size_t i = 0; i < cache.entries.size(); i++) {
+        if (cache.entries[i].key == key || cache.entries[i].epoch != epoch) {
+            victim = i;
+            break;
+        }
+    }
+    if (victim == cache.entries.size() && cache.entries.size() >= static_cast<size_t>(QUERY_CACHE_SIZE)) {
+        victim = 0;
+        for (size_t i = 1; i < cache.entries.size(); i++) {
+            if (cache.entries[i].lastUsed < cache.entries[victim].lastUsed) victim = i;
+        }
+    }
+    if (victim == cache.entries.size()) cache.entries.push_back(CachedQuery());
+
+    CachedQuery& entry = cache.entries[victim];
+    entry.key = key;
+    entry.epoch = epoch;
+    entry.lastUsed = ++cache.clock;
+    entry.slots = slots;
+}
+
+void displayCacheStats(const QueryCache& cache, unsigned long epoch) {
+    unsigned long total = cache.hits + cache.misses;
+    int fresh = 0;
+    for (size_t i = 0; i < cache.entries.size(); i++) {
+        if (cache.entries[i].epoch == epoch) fresh++;
+    }
+
+    cout << "\n--- Query Cache ---\n";
+    cout << "Hits:    " << cache.hits << "\n";
+    cout << "Misses:  " << cache.misses << "\n";
+    if (total > 0)
+        cout << "Hit rate: " << (cache.hits * 100 / total) << "%\n";
+    cout << "Entries: " << cache.entries.size() << " of " << QUERY_CACHE_SIZE
+         << " (" << fresh << " valid for the current data)\n";
+}
+
+void filterSearchMenu(Item items[], int itemCount, const ItemIndex& index, QueryCache& cache) {
+    int choice;
+    string input;
+
+    do {
+        cout << "\n--- Filter / Search Items ---\n";
+        cout << "1. By Name\n2. By Category\n3. By Description\n4. By Location\n";
+        cout << "5. By Status\n6. By Matched / Unmatched\n7. By Claimed / Unclaimed\n";
+        cout << "8. By Date\n"; 
+        cout << "9. By Date Range\n"; 
+        cout << "10. Combined Query\n"; 
+        cout << "11. Fuzzy Name Search (typo tolerant)\n"; 
+        cout << "12. By Person Name (sounds alike)\n"; 
+        cout << "13. Pattern Search (regex / glob)\n"; 
+        cout << "14. Phrase Search in Descriptions\n"; 
+        cout << "15. Similar Items (description)\n"; 
+        cout << "16. Best Matching Descriptions (ranked)\n"; 
+        cout << "17. Near a Position (radius / nearest)\n"; 
+        cout << "18. Query Cache Statistics\n"; 
+        cout << "19. Back to Main Menu\n"; 
+        cout << "Select an option: ";
+
+        if (!(cin >> choice)) {
+            cout << "Invalid input! Please enter a number.\n";
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            continue;
+        }
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+        ResultCursor cursor = emptyCursor();
+        string key;              // cache key, empty for lookups that are already index reads
+        vector<int> cached;
+        bool fromCache = false;
+        bool show = true;
+
+        switch (choice) {
+            case 1:
+                getInput(input, "Enter name: ");
+                key = "name~" + toLowerCase(trimSpaces(input));
+                fromCache = cacheLookup(cache, key, index.epoch, cached);
+                if (!fromCache) cursor = searchByName(items, itemCount, input);
+                break;
+
+            case 2:
+                getInput(input, "Enter category: ");
+                cursor = searchByCategory(index, input);
+                break;
+
+            case 3:
+                getInput(input, "Enter description: ");
+                key = "description~" + toLowerCase(trimSpaces(input));
+                fromCache = cacheLookup(cache, key, index.epoch, cached);
+                if (!fromCache) cursor = searchByDescription(items, itemCount, index, input);
+                break;
+
+            case 4:
+                getInput(input, "Enter location: ");
+                key = "location~" + toLowerCase(trimSpaces(input));
+                fromCache = cacheLookup(cache, key, index.epoch, cached);
+                if (!fromCache) cursor = searchByLocation(items, itemCount, index, input);
+                break;
+
+            case 5:
+                getStatus(input);
+                cursor = searchByStatus(index, input);
+                break;
+
+            case 6: {
+                int m;
+                while (true) {
+                    cout << "1. Matched\n2. Unmatched\nSelect: ";
+                    if (!(cin >> m)) {
+                        cout << "Invalid input! Please enter 1 or 2.\n";
+                        cin.clear();
+                        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                        continue;
+                    }
+                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+                    if (m == 1 || m == 2) break; // valid input
+                    cout << "Invalid choice! Please enter 1 or 2.\n";
+                }
+
+                cursor = filterByMatched(index, m == 1 ? 1 : 0);
+                break;
+            }
+
+
+            case 7: {
+                int c;
+                while (true) {
+                    cout << "1. Claimed\n2. Unclaimed\nSelect: ";
+                    if (!(cin >> c)) {
+                        cout << "Invalid input! Please enter 1 or 2.\n";
+                        cin.clear();
+                        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                        continue;
+                    }
+                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+                    if (c == 1 || c == 2) break; // valid input
+                    cout << "Invalid choice! Please enter 1 or 2.\n";
+                }
+
+                cursor = filterByClaimed(index, c == 1 ? 1 : 0);
+                break;
+            }
+
+
+            case 8: { // Search by Date
+                int date;
+                getValidDate("Enter date (YYYY-MM-DD): ", date);
+
+                cursor = searchByDate(index, date);
+                break;
+            }
+
+
+            case 9: { // Search by Date Range
+                int fromDate, toDate;
+                getValidDate("From date (YYYY-MM-DD): ", fromDate);
+                getValidDate("To date (YYYY-MM-DD): ", toDate);
+
+                if (fromDate > toDate) {
+                    cout << "The start date must not be after the end date.\n";
+                    show = false;
+                    break;
+                }
+
+                cursor = searchByDateRange(index, fromDate, toDate);
+                break;
+            }
+
+
+            case 10: { // Several criteria at once
+                Query query;
+                string error;
+                cout << "Fields: id, name, category, description, date, location, status,\n";
+                cout << "        matched, claimed, person, contact\n";
+                cout << "Operators: = (equals), ~ (contains), <, <=, >, >= (date/id)\n";
+                cout << "Example: status=Lost AND category=Electronics AND location~Library\n";
+                getInput(input, "Enter query: ");
+
+                if (!parseQuery(input, query, error)) {
+                    cout << "Invalid query: " << error << "\n";
+                    show = false;
+                    break;
+                }
+                key = normalizeQuery(query);
+                fromCache = cacheLookup(cache, key, index.epoch, cached);
+                if (fromCache) {
+                    cout << "(cached result)\n";
+                } else {
+                    planQuery(index, itemCount, query);
+                    explainQuery(query);
+                    cursor = openQueryCursor(items, itemCount, index, query);
+                }
+                break;
+            }
+
+
+            case 11: { // Name search that tolerates typos
+                int maxEdits;
+                getInput(input, "Enter name: ");
+                while (true) {
+                    cout << "Allowed typos (0-3): ";
+                    if (cin >> maxEdits && maxEdits >= 0 && maxEdits <= 3) {
+                        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                        break;
+                    }
+                    cout << "Invalid input! Enter a number from 0 to 3.\n";
+                    cin.clear();
+                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                }
+
+                key = "name%" + string(1, static_cast<char>('0' + maxEdits)) + ":" + toLowerCase(trimSpaces(input));
+                fromCache = cacheLookup(cache, key, index.epoch, cached);
+                if (!fromCache) cursor = searchByNameFuzzy(items, itemCount, index, trimSpaces(input), maxEdits);
+                break;
+            }
+
+
+            case 12:
+                getInput(input, "Enter owner or finder name: ");
+                cursor = searchByPerson(index, input);
+                break;
+
+
+            case 13: { // Regular expression or glob over name and description
+                int kind;
+                while (true) {
+                    cout << "1. Regular expression (e.g. i?phone 1[0-5])\n2. Glob (e.g. *wallet*brown*)\nSelect: ";
+                    if (cin >> kind && (kind == 1 || kind == 2)) {
+                        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                        break;
+                    }
+                    cout << "Invalid choice! Please enter 1 or 2.\n";
+                    cin.clear();
+                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                }
+                getInput(input, "Enter pattern: ");
+
+                CompiledPattern pattern;
+                string error;
+                if (!compilePattern(input, kind == 2, pattern, error)) {
+                    cout << "Invalid pattern: " << error << "\n";
+                    show = false;
+                    break;
+                }
+
+                key = (kind == 2 ? "glob:" : "regex:") + toLowerCase(input);
+                fromCache = cacheLookup(cache, key, index.epoch, cached);
+                if (!fromCache) cursor = searchByPattern(items, itemCount, pattern);
+                break;
+            }
+
+
+            case 14: { // Exact phrase or NEAR/k over description words
+                getInput(input, "Enter phrase (e.g. black leather, black NEAR/2 leather): ");
+                PhraseQuery phrase;
+                string error;
+                if (!parsePhrase(input, phrase, error)) {
+                    cout << "Invalid phrase: " << error << "\n";
+                    show = false;
+                    break;
+                }
+                cursor = searchByPhrase(index, phrase);
+                break;
+            }
+
+
+            case 15: { // Near-duplicate descriptions of an item, or of typed text
+                getInput(input, "Enter an item ID or a description: ");
+                int skipSlot = -1;
+                MinHashSignature sig;
+                Item* item = getItemByID(items, itemCount, atoi(input.c_str()));
+                if (item && to_string(item->id) == trimSpaces(input)) {
+                    skipSlot = static_cast<int>(item - items);
+                    sig = index.signatures[skipSlot];
+                } else {
+                    sig = minHashOf(input);
+                }
+                cursor = searchSimilarItems(index, sig, 0.5, skipSlot);
+                break;
+            }
+
+
+            case 16: { // Top descriptions by TF-IDF similarity to the typed words
+                getInput(input, "Enter words to rank descriptions by: ");
+                PruneStats stats;
+                cursor = searchRanked(index, itemCount, input, RANKED_RESULT_LIMIT, stats);
+                break;
+            }
+
+
+            case 17: { // Geo-tagged items around an item's position or typed coordinates
+                getInput(input, "Enter an item ID or latitude, longitude: ");
+                double latitude, longitude;
+                string error;
+                Item* item = getItemByID(items, itemCount, atoi(input.c_str()));
+                if (item && to_string(item->id) == trimSpaces(input)) {
+                    if (!item->hasCoordinates) {
+                        cout << "Item " << item->id << " has no position.\n";
+                        show = false;
+                        break;
+                    }
+                    latitude = item->latitude;
+                    longitude = item->longitude;
+                } else if (!parseCoordinates(input, latitude, longitude, error)) {
+                    cout << error << "\n";
+                    show = false;
+                    break;
+                }
+
+                getInput(input, "Radius in meters, or N followed by a count for the nearest (e.g. 200, N5): ");
+                vector<pair<double, int> > near;
+                if (toupper(static_cast<unsigned char>(input[0])) == 'N')
+                    near = gridNearest(index.grid, latitude, longitude, atoi(input.c_str() + 1));
+                else {
+                    double radius = atof(input.c_str());
+                    if (radius > GEO_MAX_RADIUS_M) {
+                        cout << "Radius capped at " << GEO_MAX_RADIUS_M << " m.\n";
+                        radius = GEO_MAX_RADIUS_M;
+                    }
+                    near = gridWithin(index.grid, latitude, longitude, radius);
+                }
+
+                vector<int> slots;
+                for (size_t i = 0; i < near.size(); i++) {
+                    if (item && near[i].second == item - items) continue;
+                    printf("  %4d. Item %d at %.0f m\n", static_cast<int>(slots.size() + 1), items[near[i].second].id, near[i].first);
+                    slots.push_back(near[i].second);
+                }
+                cursor = listCursor(slots);
+                break;
+            }
+
+
+            case 18:
+                displayCacheStats(cache, index.epoch);
+                show = false;
+                break;
+
+
+            case 19: // Back to Main Menu
+                return;
+
+            default:
+                cout << "Invalid choice! Please select 1-19.\n";
+                show = false;
+        }
+
+        if (show) {
+            if (fromCache) cursor = listCursor(cached);
+
+            // Only complete result lists can be cached; a search paged part-way stays lazy
+            vector<int> seen;
+            bool complete = displayResultPages(items, cursor, index, seen);
+            if (complete && !fromCache && !key.empty())
+                cacheStore(cache, key, index.epoch, seen);
+        }
+
+    } while (true);
+}
+
+
+
+
+
+
+// Standing Alerts
+// Saved queries that are checked against each item as it is added or updated,
+// e.g.  status=Found AND category=Documents AND description~passport
+// Every alert is filed under one trigram of one of its text values (for OR
+// alerts, one per predicate), so a new item only evaluates the alerts whose
+// trigram occurs in the matching field of that item. Alerts without a usable
+// text value are checked on every change.
+
+struct StandingAlert {
+    int id;
+    string text;
+    Query query;
+};
+
+struct AlertRegistry {
+    vector<StandingAlert> alerts;
+    unordered_map<string, vector<int> > anchors;   // "field:trigram" -> positions in alerts
+    vector<int> unanchored;                        // positions checked against every item
+    int anchoredFields[FIELD_COUNT];               // anchors per field, fields at 0 are never trigrammed
+    int nextID;
+
+    AlertRegistry() : nextID(1) {
+        for (int f = 0; f < FIELD_COUNT; f++) anchoredFields[f] = 0;
+    }
+};
+
+bool isAlertTextField(int field) {
+    return field != FIELD_ID && field != FIELD_DATE && field != FIELD_MATCHED && field != FIELD_CLAIMED;
+}
+
+string alertFieldText(const Item& item, int field) {
+    switch (field) {
+        case FIELD_NAME: return toLowerCase(item.name);
+        case FIELD_CATEGORY: return toLowerCase(item.category);
+        case FIELD_DESCRIPTION: return toLowerCase(item.description);
+        case FIELD_LOCATION: return toLowerCase(item.location);
+        case FIELD_STATUS: return toLowerCase(item.status);
+        case FIELD_PERSON_NAME: return toLowerCase(item.personName);
+        case FIELD_PERSON_CONTACT: return normalizeContact(item.personContact);
+    }
+    return "";
+}
+
+// Anchor key for a predicate: its least used trigram, or "" when it has none.
+// contact~ is matched against the raw contact ("555-12" in "555-123-4567")
+// while the anchors see it normalized, so it never anchors an alert.
+string alertAnchorOf(const AlertRegistry& registry, const QueryPredicate& pred) {
+    if (!isAlertTextField(pred.field)) return "";
+    if (pred.field == FIELD_PERSON_CONTACT && pred.op != OP_EQUALS) return "";
+    string value = (pred.field == FIELD_PERSON_CONTACT) ? normalizeContact(pred.value) : toLowerCase(pred.value);
+
+    string best;
+    size_t bestLoad = 0;
+    for (size_t i = 0; i + 3 <= value.size(); i++) {
+        string key = string(FIELD_NAMES[pred.field]) + ":" + value.substr(i, 3);
+        unordered_map<string, vector<int> >::const_iterator it = registry.anchors.find(key);
+        size_t load = (it == registry.anchors.end()) ? 0 : it->second.size();
+        if (best.empty() || load < bestLoad) {
+            best = key;
+            bestLoad = load;
+        }
+    }
+    return best;
+}
+
+void fileAlert(AlertRegistry& registry, int position) {
+    const Query& query = registry.alerts[position].query;
+    vector<string> keys;
+    vector<int> fields;
+
+    if (query.anyOf) {
+        // Any predicate can fire an OR alert, so every one of them needs an anchor
+        for (size_t p = 0; p < query.predicates.size(); p++) {
+            string key = alertAnchorOf(registry, query.predicates[p]);
+            if (key.empty()) {
+                keys.clear();
+                break;
+            }
+            keys.push_back(key);
+            fields.push_back(query.predicates[p].field);
+        }
+    } else {
+        // Any one predicate of an AND alert will do; contains beats equals on a
+        // small field like status, whose trigrams every other item shares
+        for (size_t p = 0; p < query.predicates.size() && keys.empty(); p++) {
+            if (query.predicates[p].op != OP_CONTAINS) continue;
+            string key = alertAnchorOf(registry, query.predicates[p]);
+            if (!key.empty()) {
+                keys.push_back(key);
+                fields.push_back(query.predicates[p].field);
+            }
+        }
+        for (size_t p = 0; p < query.predicates.size() && keys.empty(); p++) {
+            string key = alertAnchorOf(registry, query.predicates[p]);
+            if (!key.empty()) {
+                keys.push_back(key);
+                fields.push_back(query.predicates[p].field);
+            }
+        }
+    }
+
+    if (keys.empty()) {
+        registry.unanchored.push_back(position);
+        return;
+    }
+    for (size_t k = 0; k < keys.size(); k++) {
+        registry.anchors[keys[k]].push_back(position);
+        registry.anchoredFields[fields[k]]++;
+    }
+}
+
+// Used after an alert is removed, positions shift
+void refileAlerts(AlertRegistry& registry) {
+    registry.anchors.clear();
+    registry.unanchored.clear();
+    for (int f = 0; f < FIELD_COUNT; f++) registry.anchoredFields[f] = 0;
+    for (size_t i = 0; i < registry.alerts.size(); i++)
+        fileAlert(registry, static_cast<int>(i));
+}
+
+bool addAlert(AlertRegistry& registry, const string& text, int id, string& error) {
+    StandingAlert alert;
+    if (!parseQuery(text, alert.query, error)) return false;
+    alert.id = (id > 0) ? id : registry.nextID;
+    alert.text = trimSpaces(text);
+    registry.nextID = max(registry.nextID, alert.id + 1);
+    registry.alerts.push_back(alert);
+    fileAlert(registry, static_cast<int>(registry.alerts.size()) - 1);
+    return true;
+}
+
+bool removeAlert(AlertRegistry& registry, int id) {
+    for (size_t i = 0; i < registry.alerts.size(); i++) {
+        if (registry.alerts[i].id == id) {
+            registry.alerts.erase(registry.alerts.begin() + i);
+            refileAlerts(registry);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Positions of the alerts that could match item, ascending
+vector<int> alertCandidates(const AlertRegistry& registry, const Item& item) {
+    vector<int> candidates = registry.unanchored;
+    for (int f = 0; f < FIELD_COUNT; f++) {
+        if (registry.anchoredFields[f] == 0) continue;
+        string text = alertFieldText(item, f);
+        string prefix = string(FIELD_NAMES[f]) + ":";
+        for (size_t i = 0; i + 3 <= text.size(); i++) {
+            unordered_map<string, vector<int> >::const_iterator it = registry.anchors.find(prefix + text.substr(i, 3));
+            if (it != registry.anchors.end())
+                candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+        }
+    }
+    sort(candidates.begin(), candidates.end());
+    candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
+    return candidates;
+}
+
+bool itemMatchesQuery(const Item& item, const Query& query) {
+    for (size_t p = 0; p < query.predicates.size(); p++) {
+        bool hit = itemMatchesPredicate(item, query.predicates[p]);
+        if (hit == query.anyOf) return hit;
+    }
+    return !query.anyOf;
+}
+
+// Reports every alert the new or changed item satisfies, returns how many fired
+int checkAlerts(const AlertRegistry& registry, const Item& item) {
+    vector<int> candidates = alertCandidates(registry, item);
+    int fired = 0;
+    for (size_t i = 0; i < candidates.size(); i++) {
+        const StandingAlert& alert = registry.alerts[candidates[i]];
+        if (!itemMatchesQuery(item, alert.query)) continue;
+        cout << "*** Alert #" << alert.id << " matched item " << item.id << ": " << alert.text << "\n";
+        fired++;
+    }
+    return fired;
+}
+
+// One alert per line: <id>|<query>
+void saveAlerts(const AlertRegistry& registry, const char* filename) {
+    ofstream out(filename);
+    if (!out) {
+        cout << "File can't be opened.\n";
+        return;
+    }
+    for (size_t i = 0; i < registry.alerts.size(); i++)
+        out << registry.alerts[i].id << "|" << registry.alerts[i].text << "\n";
+}
+
+void loadAlerts(AlertRegistry& registry, const char* filename) {
+    ifstream in(filename);
+    if (!in) return; // no alerts saved yet
+
+    string line;
+    while (getline(in, line)) {
+        if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+        size_t bar = line.find('|');
+        if (bar == string::npos) continue;
+
+        string error;
+        if (!addAlert(registry, line.substr(bar + 1), atoi(line.substr(0, bar).c_str()), error))
+            cout << "Skipping saved alert '" << line << "': " << error << "\n";
+    }
+}
+
+void alertsMenu(AlertRegistry& registry, const char* filename) {
+    int choice;
+    string input;
+
+    do {
+        cout << "\n--- Standing Alerts ---\n";
+        cout << "1. List Alerts\n2. Add Alert\n3. Remove Alert\n4. Back to Main Menu\n";
+        cout << "Select an option: ";
+
+        if (!(cin >> choice)) {
+            cout << "Invalid input! Please enter a number.\n";
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            continue;
+        }
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+        switch (choice) {
+            case 1:
+                if (registry.alerts.empty()) {
+                    cout << "No standing alerts.\n";
+                    break;
+                }
+                for (size_t i = 0; i < registry.alerts.size(); i++)
+                    cout << "#" << registry.alerts[i].id << "  " << registry.alerts[i].text << "\n";
+                cout << registry.unanchored.size() << " of " << registry.alerts.size()
+                     << " alert(s) are checked on every change; the rest only when their text appears.\n";
                 break;
 
-            case 6: {
-                int m;
-                while (true) {
-                    cout << "1. Matched\n2. Unmatched\nSelect: ";
-                    if (!(cin >> m)) {
-                        cout << "Invalid input! Please enter 1 or 2.\n";
-                        cin.clear();
-                        cin.ignore(numeric_limits<streamsize>::max(), '\n');
-                        continue;
-                    }
-                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
-
-                    if (m == 1 || m == 2) break; // valid input
-                    cout << "Invalid choice! Please enter 1 or 2.\n";
+            case 2: {
+                cout << "Same syntax as Combined Query, e.g. status=Found AND category=Documents AND description~passport\n";
+                getInput(input, "Enter alert: ");
+                string error;
+                if (!addAlert(registry, input, 0, error)) {
+                    cout << "Invalid alert: " << error << "\n";
+                    break;
                 }
+                saveAlerts(registry, filename);
+                cout << "Alert #" << registry.alerts.back().id << " saved.\n";
+                break;
+            }
 
-                count = filterByMatched(items, itemCount, m == 1 ? 1 : 0, results);
-                displayResults(items, results, count);
+            case 3: {
+                int id;
+                cout << "Enter the alert number to remove: ";
+                if (!(cin >> id)) {
+                    cout << "Invalid input! Please enter a number.\n";
+                    cin.clear();
+                }
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                if (removeAlert(registry, id)) {
+                    saveAlerts(registry, filename);
+                    cout << "Alert #" << id << " removed.\n";
+                } else {
+                    cout << "No alert #" << id << ".\n";
+                }
                 break;
             }
 
+            case 4: // Back to Main Menu
+                return;
 
-            case 7: {
-                int c;
-                while (true) {
-                    cout << "1. Claimed\n2. Unclaimed\nSelect: ";
-                    if (!(cin >> c)) {
-                        cout << "Invalid input! Please enter 1 or 2.\n";
-                        cin.clear();
-                        cin.ignore(numeric_limits<streamsize>::max(), '\n');
-                        continue;
-                    }
-                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            default:
+                cout << "Invalid choice! Please select 1-4.\n";
+        }
+    } while (true);
+}
 
-                    if (c == 1 || c == 2) break; // valid input
-                    cout << "Invalid choice! Please enter 1 or 2.\n";
-                }
 
-                count = filterByClaimed(items, itemCount, c == 1 ? 1 : 0, results);
-                displayResults(items, results, count);
-                break;
-            }
 
 
-            case 8: { // Search by Date
-                char date[12]; 
-                getValidDate("Enter date (YYYY-MM-DD): ", date);
 
-                count = searchByDate(items, itemCount, date, results);
-                displayResults(items, results, count);
-                break;
-            }
 
 
-            case 9: // Back to Main Menu
-                delete[] results;
-                return;
+//Matching System
+// Candidates are first blocked with the index: opposite status, not matched yet,
+// same or related category, and a date within the configured window. The text
+// comparison then only runs on that block.
+
+enum MatchFeature { MATCH_NAME, MATCH_DESCRIPTION, MATCH_LOCATION, MATCH_CATEGORY, MATCH_DATE, MATCH_DISTANCE };
+const char* const MATCH_FEATURE_NAMES[] = {"name", "description", "location", "category", "date", "distance"};
+const int MATCH_FEATURE_COUNT = 6;
+
+struct MatchSettings {
+    int dateWindowDays;                              // 0 = any date
+    bool related[CATEGORY_COUNT][CATEGORY_COUNT];    // categories worth comparing against each other
+    bool trace;                                      // print block size and timing per attempt
+    double weights[MATCH_FEATURE_COUNT];             // weight of each feature in the score
+    int topK;                                        // most candidates shown per attempt
+    double minScore;                                 // weaker candidates are dropped
+    int lshBlockLimit;                               // larger blocks score LSH description neighbours first, 0 = never
+    double geoScaleMeters;                           // distance at which the distance feature is 0.5
+};
 
-            default:
-                cout << "Invalid choice! Please select 1-9.\n";
+// One scored candidate; features are each in [0, 1], score is their weighted
+// sum divided by the weights that apply, so it is in [0, 1] as well
+struct MatchCandidate {
+    int slot;
+    double score;
+    double features[MATCH_FEATURE_COUNT];
+    double weightSum;   // distance counts only when both items have coordinates
+};
+
+// Defaults: same category, Bags <-> Accessories, and Other against everything
+MatchSettings defaultMatchSettings() {
+    MatchSettings settings;
+    settings.dateWindowDays = 60;
+    settings.trace = false;    // diagnostics, see trace=on below
+    settings.weights[MATCH_NAME] = 0.30;
+    settings.weights[MATCH_DESCRIPTION] = 0.30;
+    settings.weights[MATCH_LOCATION] = 0.15;
+    settings.weights[MATCH_CATEGORY] = 0.10;
+    settings.weights[MATCH_DATE] = 0.15;
+    settings.weights[MATCH_DISTANCE] = 0.15;    // only when both items have coordinates
+    settings.geoScaleMeters = 200.0;
+    settings.topK = 5;
+    settings.minScore = 0.25;
+    // Blocks above 2000 score their LSH near-duplicates (about 95% of them are
+    // found) before the rest. That only orders the top-k search, so no match is
+    // lost; the rest of the block is still checked against its bound.
+    settings.lshBlockLimit = 2000;
+    int other = categoryIndexOf("Other");
+    for (int a = 0; a < CATEGORY_COUNT; a++) {
+        for (int b = 0; b < CATEGORY_COUNT; b++)
+            settings.related[a][b] = (a == b || a == other || b == other);
+    }
+    int bags = categoryIndexOf("Bags"), accessories = categoryIndexOf("Accessories");
+    settings.related[bags][accessories] = settings.related[accessories][bags] = true;
+    return settings;
+}
+
+// Optional text file of key=value lines, e.g.
+//   date_window_days=30
+//   related=Keys,Accessories
+//   trace=on
+//   weight_description=0.4
+//   top_k=3
+//   min_score=0.3
+//   lsh_block_limit=0
+//   geo_scale_m=300
+void loadMatchSettings(MatchSettings& settings, const char* filename) {
+    ifstream in(filename);
+    if (!in) return; // keep the defaults
+
+    string line;
+    while (getline(in, line)) {
+        line = trimSpaces(line);
+        if (line.empty() || line[0] == '#') continue;
+        size_t eq = line.find('=');
+        string key = toLowerCase(trimSpaces(line.substr(0, eq)));
+        string value = (eq == string::npos) ? "" : trimSpaces(line.substr(eq + 1));
+
+        if (key == "date_window_days" && !value.empty() && isdigit(static_cast<unsigned char>(value[0]))) {
+            settings.dateWindowDays = atoi(value.c_str());
+        } else if (key == "trace" && (value == "on" || value == "off")) {
+            settings.trace = (value == "on");
+        } else if (key == "top_k" && atoi(value.c_str()) > 0) {
+            settings.topK = atoi(value.c_str());
+        } else if (key == "lsh_block_limit" && !value.empty() && isdigit(static_cast<unsigned char>(value[0]))) {
+            settings.lshBlockLimit = atoi(value.c_str());
+        } else if (key == "geo_scale_m" && atof(value.c_str()) > 0.0) {
+            settings.geoScaleMeters = atof(value.c_str());
+        } else if (key == "min_score" && !value.empty()) {
+            settings.minScore = atof(value.c_str());
+        } else if (key.compare(0, 7, "weight_") == 0 && !value.empty()) {
+            bool known = false;
+            for (int f = 0; f < MATCH_FEATURE_COUNT; f++) {
+                if (key.substr(7) == MATCH_FEATURE_NAMES[f]) {
+                    settings.weights[f] = atof(value.c_str());
+                    known = true;
+                }
+            }
+            if (!known) cout << filename << ": ignoring '" << line << "'\n";
+        } else if (key == "related" && value.find(',') != string::npos) {
+            int a = categoryIndexOf(trimSpaces(value.substr(0, value.find(','))));
+            int b = categoryIndexOf(trimSpaces(value.substr(value.find(',') + 1)));
+            if (a != -1 && b != -1) settings.related[a][b] = settings.related[b][a] = true;
+            else cout << filename << ": unknown category in '" << line << "'\n";
+        } else {
+            cout << filename << ": ignoring '" << line << "'\n";
         }
+    }
+}
 
-    } while (true);
+// Slots that pass every blocking rule for newItem. When likely is given and the
+// block is larger than lshBlockLimit, it receives the block's items with a
+// near-duplicate description (LSH), for the caller to score first.
+Bitmap matchBlock(const ItemIndex& index, const MatchSettings& settings, const Item& newItem, Bitmap* likely = NULL) {
+    int s = statusIndexOf(newItem.status);
+    if (s == -1) return Bitmap();
+    Bitmap block = bitmapAnd(index.statusSlots[1 - s], index.matchedSlots[0]);
+
+    int c = categoryIndexOf(newItem.category);
+    if (c != -1) {
+        vector<const Bitmap*> categories;
+        for (int other = 0; other < CATEGORY_COUNT; other++) {
+            if (settings.related[c][other]) categories.push_back(&index.categorySlots[other]);
+        }
+        block = bitmapAnd(block, bitmapOrMany(categories));
+    }
+
+    if (settings.dateWindowDays > 0) {
+        map<int, Bitmap>::const_iterator from = index.dateBuckets.lower_bound(newItem.date - settings.dateWindowDays);
+        map<int, Bitmap>::const_iterator to = index.dateBuckets.upper_bound(newItem.date + settings.dateWindowDays);
+        block = bitmapAnd(block, bucketUnion(from, to));
+    }
+
+    if (likely) {
+        *likely = Bitmap();
+        if (settings.lshBlockLimit > 0 && bitmapCardinality(block) > settings.lshBlockLimit)
+            *likely = bitmapAnd(block, similarDescriptions(index, minHashOf(newItem.description)));
+    }
+    return block;
 }
 
+// Dice coefficient of two sorted term sets, or 1 when one contains the other
+double wordOverlap(const vector<int>& a, const vector<int>& b) {
+    if (a.empty() || b.empty()) return 0.0;
+    vector<int> common;
+    set_intersection(a.begin(), a.end(), b.begin(), b.end(), back_inserter(common));
+    if (common.size() == min(a.size(), b.size())) return 1.0;
+    return 2.0 * common.size() / (a.size() + b.size());
+}
+
+// Cached terms of an indexed item; any other item is normalized into scratch
+const ItemTerms& itemTermsOf(const ItemIndex& index, const Item& item, ItemTerms& scratch) {
+    unordered_map<int, int>::const_iterator slot = index.slotOfID.find(item.id);
+    if (slot != index.slotOfID.end() && slot->second < static_cast<int>(index.itemTerms.size()))
+        return index.itemTerms[slot->second];
+    scratch.name = sortedTermSet(knownTermsOf(index.normalizer, item.name));
+    scratch.location = sortedTermSet(knownTermsOf(index.normalizer, item.location));
+    scratch.description = knownTermsOf(index.normalizer, item.description);
+    scratch.locationNode = resolveLocation(index.locations, item.location);
+    return scratch;
+}
 
+// Every feature but the description, which needs the item's TF-IDF vector;
+// score holds their normalized weighted sum so far
+void scoreCheapFeatures(MatchCandidate& candidate, const Item& item, int slot, const ItemTerms& itemTerms,
+                        const Item& newItem, const ItemTerms& newTerms, const LocationTree& locations,
+                        const MatchSettings& settings) {
+    int window = settings.dateWindowDays > 0 ? settings.dateWindowDays : 90;
+    candidate.slot = slot;
+    candidate.features[MATCH_NAME] = wordOverlap(itemTerms.name, newTerms.name);
+    candidate.features[MATCH_DESCRIPTION] = 0.0;
+    if (itemTerms.locationNode != -1 && newTerms.locationNode != -1)
+        candidate.features[MATCH_LOCATION] = locationProximity(locations, itemTerms.locationNode, newTerms.locationNode);
+    else
+        candidate.features[MATCH_LOCATION] = wordOverlap(itemTerms.location, newTerms.location);
+    candidate.features[MATCH_CATEGORY] = (categoryIndexOf(item.category) == categoryIndexOf(newItem.category)) ? 1.0 : 0.5;
+    candidate.features[MATCH_DATE] = max(0.0, 1.0 - abs(item.date - newItem.date) / static_cast<double>(window));
+    candidate.features[MATCH_DISTANCE] = 0.0;
+    bool located = item.hasCoordinates && newItem.hasCoordinates;
+    if (located) {
+        double ratio = geoDistanceMeters(item.latitude, item.longitude, newItem.latitude, newItem.longitude) / settings.geoScaleMeters;
+        candidate.features[MATCH_DISTANCE] = 1.0 / (1.0 + ratio * ratio);
+    }
 
+    candidate.weightSum = 0.0;
+    for (int f = 0; f < MATCH_FEATURE_COUNT; f++) {
+        if (f != MATCH_DISTANCE || located) candidate.weightSum += settings.weights[f];
+    }
+    if (candidate.weightSum <= 0.0) candidate.weightSum = 1.0;
 
+    candidate.score = 0.0;
+    for (int f = 0; f < MATCH_FEATURE_COUNT; f++)
+        candidate.score += settings.weights[f] * candidate.features[f];
+    candidate.score /= candidate.weightSum;
+}
 
+// Highest score the candidate can reach once its description is scored
+double candidateBound(const MatchCandidate& candidate, const ItemTerms& itemTerms, const TermVector& newVector,
+                      const MatchSettings& settings) {
+    return candidate.score + settings.weights[MATCH_DESCRIPTION] / candidate.weightSum * cosineBound(newVector, itemTerms.description)
+           + 1e-9; // rounding, the bound may be met exactly
+}
 
-//Matching System
+void scoreDescription(MatchCandidate& candidate, const TermVector& itemVector, const TermVector& newVector,
+                      const MatchSettings& settings) {
+    candidate.features[MATCH_DESCRIPTION] = termCosine(newVector, itemVector);
+    candidate.score += settings.weights[MATCH_DESCRIPTION] / candidate.weightSum * candidate.features[MATCH_DESCRIPTION];
+}
 
-int* findPotentialMatches(Item items[], int itemCount, const Item& newItem, int& matchCount) {
-    int* matchIndices = new int[itemCount];
+// Fills the features and weighted score of one candidate for newItem
+void scoreCandidate(MatchCandidate& candidate, const Item& item, int slot, const ItemTerms& itemTerms,
+                    const TermVector& itemVector, const Item& newItem, const ItemTerms& newTerms,
+                    const TermVector& newVector, const LocationTree& locations, const MatchSettings& settings) {
+    scoreCheapFeatures(candidate, item, slot, itemTerms, newItem, newTerms, locations, settings);
+    scoreDescription(candidate, itemVector, newVector, settings);
+}
 
-    for (int i = 0; i < itemCount; i++) {
-        // Skip already matched items or same status
-        if (items[i].matched == 1 || items[i].status == newItem.status)
-            continue;
+bool betterCandidate(const MatchCandidate& a, const MatchCandidate& b) {
+    return a.score > b.score;
+}
+
+bool higherBound(const pair<double, MatchCandidate>& a, const pair<double, MatchCandidate>& b) {
+    return a.first > b.first;
+}
+
+// Keeps candidate in the min-heap of the best k scores seen so far
+void offerCandidate(vector<MatchCandidate>& heap, const MatchCandidate& candidate, int k) {
+    if (static_cast<int>(heap.size()) < k) {
+        heap.push_back(candidate);
+        push_heap(heap.begin(), heap.end(), betterCandidate);
+    } else if (candidate.score > heap.front().score) {
+        pop_heap(heap.begin(), heap.end(), betterCandidate);
+        heap.back() = candidate;
+        push_heap(heap.begin(), heap.end(), betterCandidate);
+    }
+}
+
+// Returns up to settings.topK candidates, best first, or NULL when none scores at least minScore.
+// Candidates are scored in full in order of their bound, and only while the
+// bound can still beat the k-th best score (usePruning = false scores all).
+// In a block larger than lshBlockLimit the near-duplicate descriptions (LSH)
+// are scored first: the heap then starts out with good scores and most of the
+// block is pruned on its bound alone. Nothing is dropped unscored, so the
+// result is the same as without LSH.
+MatchCandidate* findPotentialMatches(Item items[], int itemCount, const ItemIndex& index, const MatchSettings& settings,
+                                     const Item& newItem, int& matchCount, PruneStats* stats = NULL,
+                                     bool usePruning = true) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    Bitmap likely;
+    Bitmap block = matchBlock(index, settings, newItem, &likely);
+    int blockSize = 0, seeded = 0;
+
+    ItemTerms scratch;
+    const ItemTerms& newTerms = itemTermsOf(index, newItem, scratch);
+    TermVector newVector = descriptionVector(index, itemCount, newTerms.description);
+
+    // Min-heap on score holding the best topK seen so far. Pass 0 is the
+    // near-duplicates, pass 1 the rest of the block, each in order of bound.
+    vector<MatchCandidate> heap;
+    PruneStats work;
+    for (int pass = 0; pass < 2; pass++) {
+        const Bitmap& slots = (pass == 0) ? likely : block;
+        vector<pair<double, MatchCandidate> > bounded;
+        for (int i = bitmapNextSlot(slots, 0); i != -1 && i < itemCount; i = bitmapNextSlot(slots, i + 1)) {
+            if (pass == 1) {
+                blockSize++;
+                if (seeded > 0 && bitmapContains(likely, i)) continue;
+            } else {
+                seeded++;
+            }
+            MatchCandidate candidate;
+            scoreCheapFeatures(candidate, items[i], i, index.itemTerms[i], newItem, newTerms, index.locations, settings);
+            double bound = candidateBound(candidate, index.itemTerms[i], newVector, settings);
+            bool beaten = static_cast<int>(heap.size()) == settings.topK && bound <= heap.front().score;
+            if (usePruning && (bound < settings.minScore || beaten)) work.skipped++;
+            else bounded.push_back(make_pair(bound, candidate));
+        }
+        if (usePruning) stable_sort(bounded.begin(), bounded.end(), higherBound);
 
-        // Use case-insensitive matching for strings
-        bool match =
-            containsSubstring(items[i].name, newItem.name) ||
-            containsSubstring(newItem.name, items[i].name) ||
-            containsSubstring(items[i].category, newItem.category) ||
-            containsSubstring(newItem.category, items[i].category) ||
-            containsSubstring(items[i].description, newItem.description) ||
-            containsSubstring(newItem.description, items[i].description) ||
-            containsSubstring(items[i].location, newItem.location) ||
-            containsSubstring(newItem.location, items[i].location);
+        for (size_t b = 0; b < bounded.size(); b++) {
+            if (usePruning && static_cast<int>(heap.size()) == settings.topK && bounded[b].first <= heap.front().score) {
+                work.skipped += static_cast<long>(bounded.size() - b); // no later bound is higher
+                break;
+            }
 
-        if (match) {
-            matchIndices[matchCount++] = i;
+            MatchCandidate candidate = bounded[b].second;
+            int i = candidate.slot;
+            scoreDescription(candidate, descriptionVector(index, itemCount, index.itemTerms[i].description), newVector, settings);
+            work.scored++;
+            if (candidate.score >= settings.minScore) offerCandidate(heap, candidate, settings.topK);
         }
     }
+    sort_heap(heap.begin(), heap.end(), betterCandidate);
+    matchCount = static_cast<int>(heap.size());
+    if (stats) {
+        stats->scored += work.scored;
+        stats->skipped += work.skipped;
+    }
 
-    if (matchCount == 0) {
-        delete[] matchIndices;
-        return NULL;
+    if (settings.trace) {
+        printf("[match] item %d: %d of %d items in block (status, unmatched, category, %s%s), %ld scored, %ld pruned -> %d match(es), %.3f ms\n",
+               newItem.id, blockSize, itemCount,
+               settings.dateWindowDays > 0 ? ("+/-" + to_string(settings.dateWindowDays) + " days").c_str() : "any date",
+               seeded > 0 ? (", " + to_string(seeded) + " similar descriptions first").c_str() : "",
+               work.scored, work.skipped, matchCount, elapsedMs(start));
     }
 
-    return matchIndices;
+    if (matchCount == 0) return NULL;
+
+    MatchCandidate* matches = new MatchCandidate[matchCount];
+    copy(heap.begin(), heap.end(), matches);
+    return matches;
 }
 
 void markAsMatched(Item& item1, Item& item2) {
@@ -789,19 +4887,21 @@ void markAsMatched(Item& item1, Item& item2) {
     
 }
 
-bool markMatchByID(Item items[], int itemCount, Item& newItem, int matchID) {
+bool markMatchByID(Item items[], int itemCount, ItemIndex& index, Item& newItem, int matchID) {
 
     for (int i = 0; i < itemCount; i++) {
         if (items[i].id == matchID) {
             markAsMatched(newItem, items[i]);
+            refreshItemFlags(index, newItem, static_cast<int>(&newItem - items));
+            refreshItemFlags(index, items[i], i);
             return true;
         }
     }
     return false; // ID not found
 }
 
-void displayMatches(Item items[], int matchIndices[], int matchCount) {
-    if (matchCount == 0 || matchIndices == NULL) {
+void displayMatches(Item items[], MatchCandidate matches[], int matchCount) {
+    if (matchCount == 0 || matches == NULL) {
         cout << "No potential matches found.\n";
         cout << "------------------------------------------------------------------------------------------------------------------------------\n";
         return;
@@ -809,39 +4909,29 @@ void displayMatches(Item items[], int matchIndices[], int matchCount) {
 
     for (int i = 0; i < matchCount; i++) {
         cout << "------------------------------------------------------------------------------------------------------------------------------\n";
-        cout << "\n--- Potential Match " << i + 1 << " ---\n";
-        displayItem(items[matchIndices[i]]);
+        printf("\n--- Potential Match %d  (score %.2f: ", i + 1, matches[i].score);
+        for (int f = 0; f < MATCH_FEATURE_COUNT; f++)
+            printf("%s%s %.2f", f ? ", " : "", MATCH_FEATURE_NAMES[f], matches[i].features[f]);
+        printf(") ---\n");
+        displayItem(items[matches[i].slot]);
         cout<<endl;
         cout << "------------------------------------------------------------------------------------------------------------------------------\n";
     }
 }
 
-void searchForMatches(Item*& items, int itemCount, Item& newItem, int& nextID, const char* filename, fstream& file) {
-    //  Ask user if they want to search for matches 
-    char searchChoice;
-    while (true) {
-        string input;
-        cout << "Do you want to search for matching items now? (Y/N): ";
-        getline(cin, input); // read whole line
-
-        // Validate that input is exactly 1 character
-        if (input.length() == 1) {
-            searchChoice = tolower(input[0]); // convert to lowercase
-            if (searchChoice == 'y' || searchChoice == 'n') {
-                break; // valid input
-            }
-        }
-
-        cout << "Invalid input. Please enter only Y or N.\n";
-    }
+struct SuggestionStore;
+void forgetSuggestionsOf(SuggestionStore& store, int id);
+void saveSuggestions(const SuggestionStore& store);
 
-    if (searchChoice == 'y') {
+// Shows the best candidates for newItem and lets the operator pick one
+void reviewMatches(Item*& items, int itemCount, ItemIndex& index, const MatchSettings& matching, SuggestionStore& suggestions, Item& newItem, int& nextID, const char* filename, fstream& file) {
+    {
         // Find potential matches 
         int matchCount = 0;
-        int* matchIndices = findPotentialMatches(items, itemCount - 1, newItem, matchCount);
+        MatchCandidate* matches = findPotentialMatches(items, itemCount, index, matching, newItem, matchCount);
 
         // Display matches
-        displayMatches(items, matchIndices, matchCount);
+        displayMatches(items, matches, matchCount);
 
         if (matchCount > 0) {
             int choice;
@@ -864,15 +4954,18 @@ void searchForMatches(Item*& items, int itemCount, Item& newItem, int& nextID, c
                 // Check if the entered ID exists in the match list
                 bool valid = false;
                 for (int i = 0; i < matchCount; i++) {
-                    if (items[matchIndices[i]].id == choice) {
+                    if (items[matches[i].slot].id == choice) {
                         valid = true;
                         break;
                     }
                 }
 
                 if (valid) {
-                    if (markMatchByID(items, itemCount, newItem, choice)) {
+                    if (markMatchByID(items, itemCount, index, newItem, choice)) {
                         saveToFile(file, items, itemCount, nextID, filename);
+                        forgetSuggestionsOf(suggestions, newItem.id);
+                        forgetSuggestionsOf(suggestions, choice);
+                        saveSuggestions(suggestions);
                         break; // stop asking after a successful match
                     } else {
                         cout << "Failed to mark item ID " << choice << ".\n";
@@ -883,29 +4976,359 @@ void searchForMatches(Item*& items, int itemCount, Item& newItem, int& nextID, c
             }
         } 
 
-        delete[] matchIndices; // free memory
+        delete[] matches; // free memory
+    }
+}
+
+// Match suggestions kept per unmatched item, keyed by item ID so they survive
+// slot changes. A new or edited item is scored against its block once; it gets
+// its own best list and is offered to the list of every item it was scored
+// against, so older reports learn about newcomers without a new search.
+
+struct Suggestion {
+    int id;
+    double score;
+};
+
+struct SuggestionStore {
+    unordered_map<int, vector<Suggestion> > lists;   // item ID -> best candidates, best first
+    const char* filename;
+};
+
+// Inserts or re-scores id in a list of at most limit entries; false when it did not make the cut
+bool offerSuggestion(vector<Suggestion>& list, int id, double score, int limit) {
+    for (size_t i = 0; i < list.size(); i++) {
+        if (list[i].id == id) {
+            list.erase(list.begin() + i);
+            break;
+        }
+    }
+    size_t pos = 0;
+    while (pos < list.size() && list[pos].score >= score) pos++;
+    if (static_cast<int>(pos) >= limit) return false;
+
+    Suggestion suggestion;
+    suggestion.id = id;
+    suggestion.score = score;
+    list.insert(list.begin() + pos, suggestion);
+    if (static_cast<int>(list.size()) > limit) list.pop_back();
+    return true;
+}
+
+// Drops the item's own list and every mention of it in other lists
+void forgetSuggestionsOf(SuggestionStore& store, int id) {
+    store.lists.erase(id);
+    for (unordered_map<int, vector<Suggestion> >::iterator it = store.lists.begin(); it != store.lists.end(); ++it) {
+        vector<Suggestion>& list = it->second;
+        for (size_t i = 0; i < list.size(); i++) {
+            if (list[i].id == id) {
+                list.erase(list.begin() + i);
+                break;
+            }
+        }
+    }
+}
+
+// Re-scores the item at slot after it was added or its text changed.
+// Returns how many other items now list it.
+int refreshSuggestions(SuggestionStore& store, Item items[], int itemCount, const ItemIndex& index,
+                       const MatchSettings& settings, int slot) {
+    const Item& item = items[slot];
+    forgetSuggestionsOf(store, item.id);
+    if (item.matched) return 0;
+
+    Bitmap block = matchBlock(index, settings, item);
+    const ItemTerms& itemTerms = index.itemTerms[slot];
+    TermVector itemVector = descriptionVector(index, itemCount, itemTerms.description);
+    vector<Suggestion> own;
+    int reached = 0;
+
+    for (int c = bitmapNextSlot(block, 0); c != -1 && c < itemCount; c = bitmapNextSlot(block, c + 1)) {
+        MatchCandidate candidate;
+        scoreCheapFeatures(candidate, items[c], c, index.itemTerms[c], item, itemTerms, index.locations, settings);
+        if (candidateBound(candidate, index.itemTerms[c], itemVector, settings) < settings.minScore) continue;
+        scoreDescription(candidate, descriptionVector(index, itemCount, index.itemTerms[c].description), itemVector, settings);
+        if (candidate.score < settings.minScore) continue;
+
+        offerSuggestion(own, items[c].id, candidate.score, settings.topK);
+        if (offerSuggestion(store.lists[items[c].id], item.id, candidate.score, settings.topK)) reached++;
+    }
+    if (!own.empty()) store.lists[item.id] = own;
+    return reached;
+}
+
+// One line per item: <id>|<id>:<score>,<id>:<score>,...
+void saveSuggestions(const SuggestionStore& store) {
+    ofstream out(store.filename);
+    if (!out) {
+        cout << "File can't be opened.\n";
+        return;
+    }
+    for (unordered_map<int, vector<Suggestion> >::const_iterator it = store.lists.begin(); it != store.lists.end(); ++it) {
+        if (it->second.empty()) continue;
+        out << it->first << "|";
+        for (size_t i = 0; i < it->second.size(); i++) {
+            char entry[48];
+            snprintf(entry, sizeof(entry), "%s%d:%.4f", i ? "," : "", it->second[i].id, it->second[i].score);
+            out << entry;
+        }
+        out << "\n";
+    }
+}
+
+// Reads the saved lists; without a file, every unmatched item is scored once
+void loadSuggestions(SuggestionStore& store, Item items[], int itemCount, const ItemIndex& index,
+                     const MatchSettings& settings) {
+    store.lists.clear();
+    ifstream in(store.filename);
+    if (!in) {
+        for (int i = 0; i < itemCount; i++) {
+            if (statusIndexOf(items[i].status) == 0 && !items[i].matched)
+                refreshSuggestions(store, items, itemCount, index, settings, i);
+        }
+        saveSuggestions(store);
+        return;
+    }
+
+    string line;
+    while (getline(in, line)) {
+        size_t bar = line.find('|');
+        if (bar == string::npos) continue;
+        vector<Suggestion>& list = store.lists[atoi(line.c_str())];
+
+        size_t pos = bar + 1;
+        while (pos < line.size()) {
+            size_t comma = line.find(',', pos);
+            if (comma == string::npos) comma = line.size();
+            Suggestion suggestion;
+            if (sscanf(line.substr(pos, comma - pos).c_str(), "%d:%lf", &suggestion.id, &suggestion.score) == 2)
+                list.push_back(suggestion);
+            pos = comma + 1;
+        }
+    }
+}
+
+
+
+
+
+// Background Matching
+// Adding or editing an item only queues its ID. A worker thread scores it
+// against its block, refreshes the suggestion lists and posts a summary to the
+// inbox shown in the main menu. The menu holds dataLock while it runs an
+// action, and the worker holds it while it scores one item, so the two never
+// touch the items or the index at the same time; the worker gets its turn
+// whenever the menu is waiting for a choice.
+
+struct InboxEntry {
+    int itemID;
+    string name;
+    int candidates;     // suggestions in the item's own list
+    int bestID;         // best candidate, -1 when there is none
+    double bestScore;
+    int reached;        // existing items that now list this one
+    double ms;          // time the worker spent on it
+};
+
+struct MatchWorker {
+    mutex dataLock;             // items, index and suggestions
+    mutex queueLock;            // queue, inbox and stopping
+    condition_variable wake;
+    deque<int> queue;           // item IDs waiting to be scored
+    int scoring;                // taken off the queue, not yet in the inbox
+    vector<InboxEntry> inbox;
+    bool stopping;
+    thread runner;
+
+    MatchWorker() : scoring(0), stopping(false) {}
+};
+
+void queueForMatching(MatchWorker& worker, int id) {
+    lock_guard<mutex> lock(worker.queueLock);
+    worker.queue.push_back(id);
+    worker.wake.notify_one();
+}
+
+void matchWorkerLoop(MatchWorker& worker, Item*& items, int& itemCount, ItemIndex& index,
+                     const MatchSettings& settings, SuggestionStore& store) {
+    while (true) {
+        int id;
+        {
+            unique_lock<mutex> lock(worker.queueLock);
+            while (!worker.stopping && worker.queue.empty()) worker.wake.wait(lock);
+            if (worker.queue.empty()) return; // stopping, and nothing left to score
+            id = worker.queue.front();
+            worker.queue.pop_front();
+            worker.scoring++;
+        }
+
+        InboxEntry entry;
+        bool found = false;
+        {
+            lock_guard<mutex> lock(worker.dataLock);
+            unordered_map<int, int>::const_iterator slot = index.slotOfID.find(id);
+            if (slot != index.slotOfID.end() && !items[slot->second].matched) {
+                chrono::steady_clock::time_point start = chrono::steady_clock::now();
+                entry.itemID = id;
+                entry.name = items[slot->second].name;
+                entry.reached = refreshSuggestions(store, items, itemCount, index, settings, slot->second);
+                saveSuggestions(store);
+
+                unordered_map<int, vector<Suggestion> >::const_iterator list = store.lists.find(id);
+                entry.candidates = (list == store.lists.end()) ? 0 : static_cast<int>(list->second.size());
+                entry.bestID = entry.candidates ? list->second[0].id : -1;
+                entry.bestScore = entry.candidates ? list->second[0].score : 0.0;
+                entry.ms = elapsedMs(start);
+                found = true;
+            }
+        }
+
+        lock_guard<mutex> lock(worker.queueLock);
+        worker.scoring--;
+        if (found) worker.inbox.push_back(entry);
+    }
+}
+
+void startMatchWorker(MatchWorker& worker, Item*& items, int& itemCount, ItemIndex& index,
+                      const MatchSettings& settings, SuggestionStore& store) {
+    worker.runner = thread(matchWorkerLoop, ref(worker), ref(items), ref(itemCount), ref(index),
+                           cref(settings), ref(store));
+}
+
+// Lets the worker finish what is queued, then joins it
+void stopMatchWorker(MatchWorker& worker) {
+    {
+        lock_guard<mutex> lock(worker.queueLock);
+        worker.stopping = true;
+        worker.wake.notify_one();
     }
+    if (worker.runner.joinable()) worker.runner.join();
 }
 
+int inboxSize(MatchWorker& worker) {
+    lock_guard<mutex> lock(worker.queueLock);
+    return static_cast<int>(worker.inbox.size());
+}
+
+void suggestionInbox(Item*& items, int itemCount, ItemIndex& index, const MatchSettings& settings,
+                     SuggestionStore& store, MatchWorker& worker, int& nextID, const char* filename, fstream& file) {
+    while (true) {
+        vector<InboxEntry> entries;
+        int pending;
+        {
+            lock_guard<mutex> lock(worker.queueLock);
+            entries = worker.inbox;
+            pending = static_cast<int>(worker.queue.size()) + worker.scoring;
+        }
+
+        cout << "\n--- Suggestion Inbox ---\n";
+        if (pending > 0) cout << pending << " item(s) still being matched in the background.\n";
+        if (entries.empty()) {
+            cout << "No new suggestions.\n";
+            return;
+        }
+        for (size_t i = 0; i < entries.size(); i++) {
+            printf("%3d. Item %d %-24s %d candidate(s)", static_cast<int>(i + 1), entries[i].itemID,
+                   entries[i].name.c_str(), entries[i].candidates);
+            if (entries[i].bestID != -1) printf(", best %d (%.2f)", entries[i].bestID, entries[i].bestScore);
+            if (entries[i].reached > 0) printf(", now suggested for %d existing item(s)", entries[i].reached);
+            printf("  [%.2f ms]\n", entries[i].ms);
+        }
+
+        int choice;
+        cout << "Enter an entry number to review its matches (0 to go back, -1 to clear the inbox): ";
+        if (!(cin >> choice)) {
+            cout << "Invalid input! Please enter a number.\n";
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            continue;
+        }
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        if (choice == 0) return;
+
+        if (choice == -1 || (choice >= 1 && choice <= static_cast<int>(entries.size()))) {
+            lock_guard<mutex> lock(worker.queueLock);
+            if (choice == -1) {
+                worker.inbox.clear();
+            } else {
+                for (size_t i = 0; i < worker.inbox.size(); i++) {
+                    if (worker.inbox[i].itemID == entries[choice - 1].itemID) {
+                        worker.inbox.erase(worker.inbox.begin() + i);
+                        break;
+                    }
+                }
+            }
+        } else {
+            cout << "Invalid choice!\n";
+            continue;
+        }
+        if (choice == -1) return;
+
+        unordered_map<int, int>::const_iterator slot = index.slotOfID.find(entries[choice - 1].itemID);
+        if (slot == index.slotOfID.end() || items[slot->second].matched) {
+            cout << "Item " << entries[choice - 1].itemID << " has been deleted or matched since.\n";
+            continue;
+        }
+        reviewMatches(items, itemCount, index, settings, store, items[slot->second], nextID, filename, file);
+    }
+}
+
+
 
 
 
 
+
+// Like getInput, then offers existing values that start with what was typed
+// so the same place or item is spelled the same way every time
+void getInputWithSuggestions(string& input, const string& prompt, const ValueDictionary& dict) {
+    getInput(input, prompt);
+
+    vector<DictionaryEntry> suggestions = dictionarySuggest(dict, input, 5);
+    for (size_t i = 0; i < suggestions.size(); i++) {
+        if (suggestions[i].display == input) { // typed an existing value exactly
+            suggestions.clear();
+            break;
+        }
+    }
+    if (suggestions.empty()) return;
+
+    cout << "Existing entries starting with '" << input << "':\n";
+    for (size_t i = 0; i < suggestions.size(); i++)
+        cout << "  " << i + 1 << ". " << suggestions[i].display << " (" << suggestions[i].count << ")\n";
+
+    string choice;
+    while (true) {
+        cout << "Choose 1-" << suggestions.size() << " to use it, or press Enter to keep '" << input << "': ";
+        getline(cin, choice);
+        if (choice.empty()) return;
+
+        int pick = atoi(choice.c_str());
+        if (pick >= 1 && pick <= static_cast<int>(suggestions.size())) {
+            input = suggestions[pick - 1].display;
+            return;
+        }
+        cout << "Invalid choice.\n";
+    }
+}
+
 //Add Item Operations
-void addLostItem(Item*& items, int& itemCount, int& capacity, int& nextID, const char* filename,fstream &file) {
+void addLostItem(Item*& items, int& itemCount, int& capacity, ItemIndex& index, const AlertRegistry& alerts, MatchWorker& worker, int& nextID, const char* filename,fstream &file) {
     if (itemCount == capacity)
         resizeArray(items, capacity);
 
     Item newItem;
     newItem.id = nextID++;
 
-    getInput(newItem.name, "Enter Item Name: ");
+    getInputWithSuggestions(newItem.name, "Enter Item Name: ", index.nameValues);
     selectCategory(newItem.category);
     getInput(newItem.description, "Enter Description: ");
     getValidDate("Enter Date Found (YYYY-MM-DD): ", newItem.date);
-    getInput(newItem.location, "Enter Location Found: ");
+    getInputWithSuggestions(newItem.location, "Enter Location Found: ", index.locationValues);
     getInput(newItem.personName, "Enter owner Name : ", true);
     getInput(newItem.personContact, "Enter owner Contact : ", true);
+    getCoordinates(newItem, "Enter where it was lost as latitude, longitude (Optional): ");
+    newItem.personContact = normalizeContact(newItem.personContact);
 
 
     newItem.status = "Lost";
@@ -914,31 +5337,33 @@ void addLostItem(Item*& items, int& itemCount, int& capacity, int& nextID, const
     newItem.matchedItemID = -1;
 
     items[itemCount++] = newItem;
+    indexItem(index, items[itemCount - 1], itemCount - 1);
     saveToFile(file, items, itemCount, nextID, filename);
 
     cout << "\nLost item added! ID: " << newItem.id << "\n";
-
+    checkAlerts(alerts, items[itemCount - 1]);
+    queueForMatching(worker, newItem.id);
+    cout << "Looking for matches in the background; see the Suggestion Inbox.\n";
    cout << "------------------------------------------------------------------------------------------------------------------------------\n";
-    // Call the new match search function
-    searchForMatches(items, itemCount, items[itemCount - 1], nextID, filename,file);
-    //items[itemCount - 1] - last item added
     pause();
 }
 
-void addFoundItem(Item*& items, int& itemCount, int& capacity, int& nextID, const char* filename,fstream &file) {
+void addFoundItem(Item*& items, int& itemCount, int& capacity, ItemIndex& index, const AlertRegistry& alerts, MatchWorker& worker, int& nextID, const char* filename,fstream &file) {
     if (itemCount == capacity)
         resizeArray(items, capacity);
 
     Item newItem;
     newItem.id = nextID++;
 
-    getInput(newItem.name, "Enter Item Name: ");
+    getInputWithSuggestions(newItem.name, "Enter Item Name: ", index.nameValues);
     selectCategory(newItem.category);
     getInput(newItem.description, "Enter Description: ");
     getValidDate("Enter Date Found (YYYY-MM-DD): ", newItem.date);
-    getInput(newItem.location, "Enter Location Found: ");
+    getInputWithSuggestions(newItem.location, "Enter Location Found: ", index.locationValues);
     getInput(newItem.personName, "Enter Finder Name (Optional): ", true);
     getInput(newItem.personContact, "Enter Finder Contact (Optional): ", true);
+    getCoordinates(newItem, "Enter where it was found as latitude, longitude (Optional): ");
+    newItem.personContact = normalizeContact(newItem.personContact);
 
 
     newItem.status = "Found";
@@ -947,15 +5372,16 @@ void addFoundItem(Item*& items, int& itemCount, int& capacity, int& nextID, cons
     newItem.matchedItemID = -1;
 
     items[itemCount++] = newItem;
+    indexItem(index, items[itemCount - 1], itemCount - 1);
 
     saveToFile(file, items, itemCount, nextID, filename);
 
     cout << "\nFound item added! ID: " << newItem.id << "\n";
+    checkAlerts(alerts, items[itemCount - 1]);
+    queueForMatching(worker, newItem.id);
+    cout << "Looking for matches in the background; see the Suggestion Inbox.\n";
     cout << "------------------------------------------------------------------------------------------------------------------------------\n";
 
-    // Reuse the search function
-    searchForMatches(items, itemCount, items[itemCount - 1], nextID, filename,file);
-
     pause();
 }
 
@@ -984,7 +5410,8 @@ void updateItemMenu(Item* item) {
 		cout << "6. Person Name\n"; 
 		cout << "7. Person Contact\n"; 
 		cout << "8. All Fields\n"; 
-		cout << "9. Return to Main Menu\n";
+		cout << "9. Position (latitude, longitude)\n"; 
+		cout << "10. Return to Main Menu\n";
 		cout << "Select an option: ";
 
 
@@ -1023,6 +5450,7 @@ void updateItemMenu(Item* item) {
                 break;
             case 7:
                 getInput(item->personContact, "New Person Contact: ", true);
+                item->personContact = normalizeContact(item->personContact);
                 cout << "Person Contact updated successfully!\n";
                 break;
             case 8: // Update all fields
@@ -1033,18 +5461,24 @@ void updateItemMenu(Item* item) {
                 getInput(item->location, "New Location: ");
                 getInput(item->personName, "New Person Name : ", true);
                 getInput(item->personContact, "New Person Contact : ", true);
+                item->personContact = normalizeContact(item->personContact);
+                getCoordinates(*item, "New Position as latitude, longitude (Optional): ");
                 cout << "All fields updated successfully!\n";
                 break;
             case 9:
+                getCoordinates(*item, "New Position as latitude, longitude (empty to remove): ");
+                cout << "Position updated successfully!\n";
+                break;
+            case 10:
                 return; // exit menu
             default:
-                cout << "Invalid option. Please select 1-9.\n";
+                cout << "Invalid option. Please select 1-10.\n";
         }
 
     } while (true);
 }
 
-void updateItem(Item items[], int itemCount, const char* filename, int nextID,fstream &file) {
+void updateItem(Item items[], int itemCount, ItemIndex& index, const AlertRegistry& alerts, MatchWorker& worker, const char* filename, int nextID,fstream &file) {
     if (itemCount == 0) {
         cout << "No items available to update.\n";
         return;
@@ -1072,8 +5506,14 @@ void updateItem(Item items[], int itemCount, const char* filename, int nextID,fs
     cout<< "Item details "<<endl;
 
     displayItem(*item); // Show current details
+
+    int slot = static_cast<int>(item - items);
+    unindexItem(index, *item, slot);
     updateItemMenu(item); // Let user update fields
+    indexItem(index, *item, slot);
     saveToFile(file, items, itemCount, nextID, filename);
+    checkAlerts(alerts, *item);
+    queueForMatching(worker, item->id);
 }
 
 
@@ -1087,7 +5527,7 @@ void updateItem(Item items[], int itemCount, const char* filename, int nextID,fs
 
 //Delete Function
 
-void deleteItem(Item*& items, int& itemCount, int& nextID, const char* filename, fstream& file) {
+void deleteItem(Item*& items, int& itemCount, ItemIndex& itemIndex, SuggestionStore& suggestions, int& nextID, const char* filename, fstream& file) {
     if (itemCount == 0) {
         cout << "No items available to delete.\n";
         return;
@@ -1147,9 +5587,12 @@ void deleteItem(Item*& items, int& itemCount, int& nextID, const char* filename,
         items[i] = items[i + 1];
     }
     itemCount--;
+    rebuildIndex(itemIndex, items, itemCount); // slots after the deleted one have shifted
 
     // Save updated array to file
     saveToFile(file, items, itemCount, nextID, filename);
+    forgetSuggestionsOf(suggestions, id);
+    saveSuggestions(suggestions);
 
     cout << "Item deleted successfully!\n";
 }
@@ -1161,44 +5604,14 @@ void deleteItem(Item*& items, int& itemCount, int& nextID, const char* filename,
 
 
 // Marking Functions
-void markItemAsMatched(Item items[], int itemCount, int nextID, const char* filename, fstream& file) {
-    if (itemCount < 2) {
-        cout << "Not enough items to mark as matched.\n";
-        return;
-    }
-
-    int id1, id2;
-
-    // Get first item ID
-    while (true) {
-        cout << "Enter the ID of the first item to match: ";
-        if (cin >> id1) {
-            cin.ignore(numeric_limits<streamsize>::max(), '\n');
-            break;
-        } else {
-            cout << "Invalid input! Enter a number.\n";
-            cin.clear();
-            cin.ignore(numeric_limits<streamsize>::max(), '\n');
-        }
-    }
-
-    // Get second item ID
-    while (true) {
-        cout << "Enter the ID of the second item to match: ";
-        if (cin >> id2) {
-            cin.ignore(numeric_limits<streamsize>::max(), '\n');
-            break;
-        } else {
-            cout << "Invalid input! Enter a number.\n";
-            cin.clear();
-            cin.ignore(numeric_limits<streamsize>::max(), '\n');
-        }
-    }
 
+// Validates and records a Lost/Found match between two IDs; shared by the
+// manual menu and bulk acceptance of batch proposals
+bool matchItemsByID(Item items[], int itemCount, ItemIndex& index, int id1, int id2) {
     // Ensure IDs are different
     if (id1 == id2) {
         cout << "Cannot match an item with itself.\n";
-        return;
+        return false;
     }
 
     // Find both items
@@ -1212,31 +5625,88 @@ void markItemAsMatched(Item items[], int itemCount, int nextID, const char* file
 
     if (!item1 || !item2) {
         cout << "One or both item IDs not found.\n";
-        return;
+        return false;
     }
 
     // Check that one is Lost and the other is Found
     if ((item1->status == "Lost" && item2->status == "Lost") ||
         (item1->status == "Found" && item2->status == "Found")) {
         cout << "Invalid match! You can only match a Lost item with a Found item.\n";
+        return false;
+    }
+
+    // Check if either item is already matched
+    if (item1->matched || item2->matched) {
+        cout << "One or both items are already matched.\n";
+        return false;
+    }
+
+    // Mark them as matched
+    markAsMatched(*item1, *item2);
+    refreshItemFlags(index, *item1, static_cast<int>(item1 - items));
+    refreshItemFlags(index, *item2, static_cast<int>(item2 - items));
+
+    return true;
+}
+
+void markItemAsMatched(Item items[], int itemCount, ItemIndex& index, SuggestionStore& suggestions, int nextID, const char* filename, fstream& file) {
+    if (itemCount < 2) {
+        cout << "Not enough items to mark as matched.\n";
         return;
     }
 
-    // Check if either item is already matched
-    if (item1->matched || item2->matched) {
-        cout << "One or both items are already matched.\n";
-        return;
+    int id1, id2;
+
+    // Get first item ID
+    while (true) {
+        cout << "Enter the ID of the first item to match: ";
+        if (cin >> id1) {
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            break;
+        } else {
+            cout << "Invalid input! Enter a number.\n";
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
     }
 
-    // Mark them as matched
-    markAsMatched(*item1, *item2);
+    // Get second item ID
+    while (true) {
+        cout << "Enter the ID of the second item to match: ";
+        if (cin >> id2) {
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            break;
+        } else {
+            cout << "Invalid input! Enter a number.\n";
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+    }
 
-    // Save changes to file
-    saveToFile(file, items, itemCount, nextID, filename);
+    if (matchItemsByID(items, itemCount, index, id1, id2)) {
+        // Save changes to file
+        saveToFile(file, items, itemCount, nextID, filename);
+        forgetSuggestionsOf(suggestions, id1);
+        forgetSuggestionsOf(suggestions, id2);
+        saveSuggestions(suggestions);
+    }
 }
 
-void markAsClaimed(Item items[], int itemCount, const char* filename, int nextID, fstream& file) {
+void markAsClaimed(Item items[], int itemCount, ItemIndex& index, const char* filename, int nextID, fstream& file) {
     int id;
+    string claimant;
+
+    // Show what the claimant has on record before asking for an ID
+    getInput(claimant, "Enter the claimant's phone or email (Enter to skip): ", true);
+    claimant = normalizeContact(claimant);
+    if (!claimant.empty()) {
+        int* results = new int[itemCount > 0 ? itemCount : 1];
+        ResultCursor cursor = searchOpenByContact(index, claimant);
+        int count = drainCursor(cursor, results);
+        if (count == 0) cout << "No open items are registered to " << claimant << ".\n";
+        else displayResults(items, results, count);
+        delete[] results;
+    }
 
     // Input validation loop
     while (true) {
@@ -1273,13 +5743,37 @@ void markAsClaimed(Item items[], int itemCount, const char* filename, int nextID
         return;
     }
 
+    // The claimant should be the contact on this item or on the item it was matched with
+    if (!claimant.empty()) {
+        Item* partner = getItemByID(items, itemCount, item->matchedItemID);
+        bool owns = normalizeContact(item->personContact) == claimant ||
+                    (partner && normalizeContact(partner->personContact) == claimant);
+        if (!owns) {
+            string confirm;
+            while (true) {
+                cout << "This contact is not on record for the item. Claim anyway? (Y/N): ";
+                getline(cin, confirm);
+                if (confirm == "Y" || confirm == "y" || confirm == "N" || confirm == "n") break;
+                cout << "Invalid input. Please enter only Y or N.\n";
+            }
+            if (confirm == "N" || confirm == "n") {
+                cout << "Claim cancelled.\n";
+                return;
+            }
+        }
+    }
+
     // Mark the item as claimed
     item->claimed = 1;
+    refreshItemFlags(index, *item, static_cast<int>(item - items));
 
     // Mark the matched item as claimed too
     if (item->matchedItemID != -1) {
         Item* matchedItem = getItemByID(items, itemCount, item->matchedItemID);
-        if (matchedItem) matchedItem->claimed = 1;
+        if (matchedItem) {
+            matchedItem->claimed = 1;
+            refreshItemFlags(index, *matchedItem, static_cast<int>(matchedItem - items));
+        }
     }
 
     saveToFile(file, items, itemCount, nextID, filename);
@@ -1297,6 +5791,295 @@ void markAsClaimed(Item items[], int itemCount, const char* filename, int nextID
 
 
 
+// Batch Matching
+// Proposes one-to-one matches for the whole backlog at once. Every unmatched
+// Lost item is scored against its block of Found items (same rules and scores
+// as searchForMatches), split across worker threads; the pairs are then
+// assigned greedily, best score first, so each item appears in at most one
+// proposal. Proposals go to a text file that staff accept or reject later.
+
+struct MatchProposal {
+    int lostID;
+    int foundID;
+    double score;
+};
+
+// Read-only inputs shared by the worker threads
+struct BatchJob {
+    Item* items;
+    int itemCount;
+    const ItemIndex* index;
+    const MatchSettings* settings;
+    vector<int> lostSlots;
+    vector<TermVector> vectors;   // description vector per slot, empty for matched items
+};
+
+void scoreLostItems(const BatchJob& job, int first, int step, vector<MatchProposal>& out, long& pairsScored) {
+    for (size_t l = first; l < job.lostSlots.size(); l += step) {
+        int lost = job.lostSlots[l];
+        Bitmap block = matchBlock(*job.index, *job.settings, job.items[lost]);
+        for (int f = bitmapNextSlot(block, 0); f != -1 && f < job.itemCount; f = bitmapNextSlot(block, f + 1)) {
+            MatchCandidate candidate;
+            scoreCandidate(candidate, job.items[f], f, job.index->itemTerms[f], job.vectors[f],
+                           job.items[lost], job.index->itemTerms[lost], job.vectors[lost], job.index->locations,
+                           *job.settings);
+            pairsScored++;
+            if (candidate.score < job.settings->minScore) continue;
+
+            MatchProposal proposal;
+            proposal.lostID = job.items[lost].id;
+            proposal.foundID = job.items[f].id;
+            proposal.score = candidate.score;
+            out.push_back(proposal);
+        }
+    }
+}
+
+bool betterProposal(const MatchProposal& a, const MatchProposal& b) {
+    if (a.score != b.score) return a.score > b.score;
+    return a.lostID != b.lostID ? a.lostID < b.lostID : a.foundID < b.foundID; // same result on every run
+}
+
+vector<MatchProposal> proposeMatches(Item items[], int itemCount, const ItemIndex& index, const MatchSettings& settings,
+                                     int threadCount, long& pairsScored) {
+    BatchJob job;
+    job.items = items;
+    job.itemCount = itemCount;
+    job.index = &index;
+    job.settings = &settings;
+    job.vectors.resize(itemCount);
+    for (int i = bitmapNextSlot(index.matchedSlots[0], 0); i != -1 && i < itemCount; i = bitmapNextSlot(index.matchedSlots[0], i + 1)) {
+        job.vectors[i] = descriptionVector(index, itemCount, index.itemTerms[i].description);
+        if (statusIndexOf(items[i].status) == 0) job.lostSlots.push_back(i);
+    }
+
+    if (threadCount < 1) threadCount = 1;
+    vector<vector<MatchProposal> > outputs(threadCount);
+    vector<long> pairs(threadCount, 0);
+    vector<thread> workers;
+    for (int t = 1; t < threadCount; t++)
+        workers.push_back(thread(scoreLostItems, cref(job), t, threadCount, ref(outputs[t]), ref(pairs[t])));
+    scoreLostItems(job, 0, threadCount, outputs[0], pairs[0]);
+    for (size_t t = 0; t < workers.size(); t++) workers[t].join();
+
+    vector<MatchProposal> scored;
+    pairsScored = 0;
+    for (int t = 0; t < threadCount; t++) {
+        scored.insert(scored.end(), outputs[t].begin(), outputs[t].end());
+        pairsScored += pairs[t];
+    }
+
+    // Greedy one-to-one assignment
+    sort(scored.begin(), scored.end(), betterProposal);
+    unordered_map<int, bool> taken;
+    vector<MatchProposal> proposals;
+    for (size_t i = 0; i < scored.size(); i++) {
+        if (taken.count(scored[i].lostID) || taken.count(scored[i].foundID)) continue;
+        taken[scored[i].lostID] = true;
+        taken[scored[i].foundID] = true;
+        proposals.push_back(scored[i]);
+    }
+    return proposals;
+}
+
+int defaultThreadCount() {
+    unsigned cores = thread::hardware_concurrency();
+    return cores > 0 ? static_cast<int>(cores) : 1;
+}
+
+// One proposal per line: <lost id>|<found id>|<score>
+bool saveProposals(const vector<MatchProposal>& proposals, const char* filename) {
+    ofstream out(filename);
+    if (!out) {
+        cout << "File can't be opened.\n";
+        return false;
+    }
+    out << "# lost id|found id|score\n";
+    for (size_t i = 0; i < proposals.size(); i++) {
+        char score[32];
+        snprintf(score, sizeof(score), "%.3f", proposals[i].score);
+        out << proposals[i].lostID << "|" << proposals[i].foundID << "|" << score << "\n";
+    }
+    return true;
+}
+
+bool loadProposals(vector<MatchProposal>& proposals, const char* filename) {
+    ifstream in(filename);
+    if (!in) return false;
+
+    proposals.clear();
+    string line;
+    while (getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        MatchProposal proposal;
+        if (sscanf(line.c_str(), "%d|%d|%lf", &proposal.lostID, &proposal.foundID, &proposal.score) == 3)
+            proposals.push_back(proposal);
+    }
+    return true;
+}
+
+// Runs the matcher and writes the proposal file; used by the menu and --batch-match
+void runBatchMatching(Item items[], int itemCount, const ItemIndex& index, const MatchSettings& settings,
+                      const char* proposalsFile) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    long pairsScored = 0;
+    int threads = defaultThreadCount();
+    vector<MatchProposal> proposals = proposeMatches(items, itemCount, index, settings, threads, pairsScored);
+    double ms = elapsedMs(start);
+
+    if (!saveProposals(proposals, proposalsFile)) return;
+    printf("Scored %ld pairs on %d thread(s) in %.1f ms; %d proposal(s) written to %s\n",
+           pairsScored, threads, ms, static_cast<int>(proposals.size()), proposalsFile);
+}
+
+void reviewProposals(Item items[], int itemCount, ItemIndex& index, SuggestionStore& suggestions, int nextID,
+                     const char* filename, const char* proposalsFile, fstream& file) {
+    vector<MatchProposal> proposals;
+    if (!loadProposals(proposals, proposalsFile) || proposals.empty()) {
+        cout << "No proposals to review. Run the batch matcher first.\n";
+        return;
+    }
+
+    for (size_t i = 0; i < proposals.size(); i++) {
+        Item* lost = getItemByID(items, itemCount, proposals[i].lostID);
+        Item* found = getItemByID(items, itemCount, proposals[i].foundID);
+        printf("%3d. %.2f  Lost %d %-24s <-> Found %d %s\n", static_cast<int>(i + 1), proposals[i].score,
+               proposals[i].lostID, lost ? lost->name.c_str() : "(deleted)",
+               proposals[i].foundID, found ? found->name.c_str() : "(deleted)");
+    }
+
+    string input;
+    while (true) {
+        cout << "Accept (A)ll, (R)eview one by one, or (N)one? ";
+        getline(cin, input);
+        if (input.size() == 1 && strchr("aArRnN", input[0])) break;
+        cout << "Invalid input. Please enter A, R or N.\n";
+    }
+    char mode = static_cast<char>(tolower(input[0]));
+    if (mode == 'n') return;
+
+    int accepted = 0;
+    for (size_t i = 0; i < proposals.size(); i++) {
+        if (mode == 'r') {
+            cout << "Match Lost " << proposals[i].lostID << " with Found " << proposals[i].foundID << "? (Y/N): ";
+            getline(cin, input);
+            if (input.empty() || tolower(input[0]) != 'y') continue;
+        }
+        if (matchItemsByID(items, itemCount, index, proposals[i].lostID, proposals[i].foundID)) {
+            forgetSuggestionsOf(suggestions, proposals[i].lostID);
+            forgetSuggestionsOf(suggestions, proposals[i].foundID);
+            accepted++;
+        }
+    }
+
+    if (accepted > 0) {
+        saveToFile(file, items, itemCount, nextID, filename);
+        saveSuggestions(suggestions);
+    }
+    remove(proposalsFile); // the rest would be stale after these matches
+    cout << accepted << " match(es) accepted.\n";
+}
+
+void batchMatchMenu(Item items[], int itemCount, ItemIndex& index, const MatchSettings& settings,
+                    SuggestionStore& suggestions, int nextID, const char* filename, const char* proposalsFile, fstream& file) {
+    int choice;
+    do {
+        cout << "\n--- Batch Matching ---\n";
+        cout << "1. Propose Matches for All Unmatched Items\n2. Review / Accept Proposals\n3. Back to Main Menu\n";
+        cout << "Select an option: ";
+
+        if (!(cin >> choice)) {
+            cout << "Invalid input! Please enter a number.\n";
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            continue;
+        }
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+        switch (choice) {
+            case 1: runBatchMatching(items, itemCount, index, settings, proposalsFile); break;
+            case 2: reviewProposals(items, itemCount, index, suggestions, nextID, filename, proposalsFile, file); break;
+            case 3: return;
+            default: cout << "Invalid choice! Please select 1-3.\n";
+        }
+    } while (true);
+}
+
+
+
+
+
+
+
+// Suggestions for one item: a hash lookup of its list, then of each candidate's slot
+void showSuggestions(Item items[], int itemCount, ItemIndex& index, SuggestionStore& store, int nextID,
+                     const char* filename, fstream& file) {
+    int id;
+    cout << "Enter the ID of the item: ";
+    if (!(cin >> id)) {
+        cout << "Invalid input! Please enter a number.\n";
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        return;
+    }
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+    unordered_map<int, int>::const_iterator self = index.slotOfID.find(id);
+    if (self == index.slotOfID.end()) {
+        cout << "Item with ID " << id << " not found.\n";
+        return;
+    }
+    if (items[self->second].matched) {
+        cout << "Item " << id << " is already matched with item " << items[self->second].matchedItemID << ".\n";
+        return;
+    }
+
+    unordered_map<int, vector<Suggestion> >::const_iterator it = store.lists.find(id);
+    vector<int> shown;
+    cout << "\n--- Suggested matches for item " << id << " (" << items[self->second].name << ") ---\n";
+    for (size_t i = 0; it != store.lists.end() && i < it->second.size(); i++) {
+        unordered_map<int, int>::const_iterator slot = index.slotOfID.find(it->second[i].id);
+        if (slot == index.slotOfID.end() || items[slot->second].matched) continue; // deleted or taken since
+        printf("score %.2f  ", it->second[i].score);
+        displayResultRow(items[slot->second]);
+        shown.push_back(it->second[i].id);
+    }
+    if (shown.empty()) {
+        cout << "No suggestions yet.\n";
+        return;
+    }
+
+    int choice;
+    while (true) {
+        cout << "Enter the ID of the item to mark as matched (0 to stop): ";
+        if (!(cin >> choice)) {
+            cout << "Invalid input. Enter a number.\n";
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            continue;
+        }
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        if (choice == 0) return;
+        if (find(shown.begin(), shown.end(), choice) == shown.end()) {
+            cout << "Invalid match ID. Please enter a valid ID from the list.\n";
+            continue;
+        }
+        if (matchItemsByID(items, itemCount, index, id, choice)) {
+            saveToFile(file, items, itemCount, nextID, filename);
+            forgetSuggestionsOf(store, id);
+            forgetSuggestionsOf(store, choice);
+            saveSuggestions(store);
+        }
+        return;
+    }
+}
+
+
+
+
+
+
+
 // Sorting System
 void swapItems(Item& a, Item& b) {
     Item temp = a;
@@ -1340,8 +6123,8 @@ void sortByCategory(Item items[], int itemCount, bool ascending = true) {
 void sortByDate(Item items[], int itemCount, bool ascending) {
     for (int i = 0; i < itemCount - 1; i++) {
         for (int j = 0; j < itemCount - i - 1; j++) {
-            if ((ascending && strcmp(items[j].date, items[j + 1].date) > 0) ||
-                (!ascending && strcmp(items[j].date, items[j + 1].date) < 0)) {
+            if ((ascending && items[j].date > items[j + 1].date) ||
+                (!ascending && items[j].date < items[j + 1].date)) {
                 swapItems(items[j], items[j + 1]);
             }
         }
@@ -1360,7 +6143,7 @@ void sortByStatus(Item items[], int itemCount, bool lostFirst) {
     }
 }
 
-void sortMenu(Item items[], int itemCount, const char* filename, int nextID, fstream& file) {
+void sortMenu(Item items[], int itemCount, ItemIndex& index, const char* filename, int nextID, fstream& file) {
     int choice;
     int order;
 
@@ -1443,6 +6226,7 @@ void sortMenu(Item items[], int itemCount, const char* filename, int nextID, fst
             case 4: sortByDate(items, itemCount, ascendingOrLostFirst); break;
             case 5: sortByStatus(items, itemCount, ascendingOrLostFirst); break;
         }
+        rebuildIndex(index, items, itemCount); // every slot may have moved
 
         saveToFile(file, items, itemCount, nextID, filename);
         cout << "Items sorted successfully!\n";
@@ -1496,7 +6280,21 @@ void showHelp() {
 
     cout << "5. Filter / Search Items\n";
     cout << "   - Search items by name, category, description, location,\n";
-    cout << "     status (Lost/Found), matched, or claimed.\n\n";
+    cout << "     status (Lost/Found), matched, claimed, or by the owner/finder\n";
+    cout << "     name, which also finds names that are spelled differently.\n";
+    cout << "   - Combined Query joins several criteria with AND / OR,\n";
+    cout << "     e.g. status=Lost AND category=Electronics AND matched=no\n";
+    cout << "     AND / OR must be upper case; quote a value to keep them in it.\n";
+    cout << "   - Pattern Search takes a regular expression (i?phone 1[0-5])\n";
+    cout << "     or a glob (*wallet*brown*) over names and descriptions.\n";
+    cout << "   - Phrase Search finds words side by side in descriptions\n";
+    cout << "     (black leather) or close together (black NEAR/2 leather).\n";
+    cout << "   - Similar Items lists items whose description is worded\n";
+    cout << "     almost the same way as an item's, or as text you type.\n";
+    cout << "   - Best Matching Descriptions shows the ten descriptions that\n";
+    cout << "     share the most (and the rarest) of your words.\n";
+    cout << "   - Near a Position lists geo-tagged items within a radius of an\n";
+    cout << "     item or of coordinates, or the nearest few.\n\n";
 
     cout << "6. Delete Item\n";
     cout << "   - Permanently remove an item using its ID.\n\n";
@@ -1510,13 +6308,45 @@ void showHelp() {
     cout << "9. Clear All Items\n";
     cout << "   - Delete all items from the system (requires confirmation).\n\n";
 
-    cout << "10. Exit\n";
+    cout << "10. Standing Alerts\n";
+    cout << "    - Save a query (same syntax as Combined Query) and get told\n";
+    cout << "      whenever an added or updated item matches it.\n\n";
+
+    cout << "11. Statistics\n";
+    cout << "    - Distinct values, the most common categories, locations and\n";
+    cout << "      name words, and a month-by-month histogram of item dates.\n\n";
+
+    cout << "12. Batch Matching\n";
+    cout << "    - Propose one-to-one matches for every unmatched item at once,\n";
+    cout << "      then accept them all or one by one. Can also run unattended\n";
+    cout << "      with --batch-match, e.g. from a nightly job.\n\n";
+
+    cout << "13. Match Suggestions for an Item\n";
+    cout << "    - Best candidate matches for one item, kept up to date as\n";
+    cout << "      new reports come in, so no new search is needed.\n\n";
+
+    cout << "14. Suggestion Inbox\n";
+    cout << "    - Reports are matched in the background right after they are\n";
+    cout << "      saved; the results collect here for review.\n\n";
+
+    cout << "15. Exit\n";
     cout << "    - Safely exit the application.\n\n";
 
     cout << "MATCHING SYSTEM\n";
    cout << "------------------------------------------------------------------------------------------------------------------------------\n";
     cout << "- The app automatically suggests matches based on:\n";
-    cout << "  name, category, description, and location.\n";
+    cout << "  name, description, and location, among unmatched items of the\n";
+    cout << "  other status in the same or a related category, reported within\n";
+    cout << "  60 days (both can be changed in matching.cfg).\n";
+    cout << "- Words are compared after plurals and common synonyms are folded\n";
+    cout << "  together (phone/mobile, bag/backpack); add your own in\n";
+    cout << "  synonyms.txt as lines like: phone = mobile, cellphone\n";
+    cout << "- Optionally list your places in locations.txt, one path per line:\n";
+    cout << "  Main Campus > Library > Floor 2|2nd floor > Reading Room\n";
+    cout << "  Locations are then compared by how close they are in that tree,\n";
+    cout << "  and searching a location also finds everything inside it.\n";
+    cout << "- Reports may carry a position (latitude, longitude); when both\n";
+    cout << "  items have one, nearby reports score higher.\n";
     cout << "- Matches can be confirmed manually.\n\n";
 
     cout << "IMPORTANT NOTES\n";
@@ -1550,7 +6380,7 @@ void displayWelcomeMessage() {
 
 
 //Main Menu Controller
-void mainMenu(Item*& items, int& itemCount, int& capacity, int& nextID, const char* filename, fstream& file) {
+void mainMenu(Item*& items, int& itemCount, int& capacity, ItemIndex& index, QueryCache& cache, AlertRegistry& alerts, const MatchSettings& matching, SuggestionStore& suggestions, MatchWorker& worker, int& nextID, const char* filename, const char* alertsFile, const char* proposalsFile, fstream& file) {
     int choice;
 
     do {
@@ -1568,17 +6398,22 @@ void mainMenu(Item*& items, int& itemCount, int& capacity, int& nextID, const ch
         cout << "  9. Mark Items as Matched\n";
         cout << " 10. Sort Items\n";
         cout << " 11. Clear All Items\n";
-        cout << " 12. Exit\n";
+        cout << " 12. Standing Alerts\n";
+        cout << " 13. Statistics\n";
+        cout << " 14. Batch Matching\n";
+        cout << " 15. Match Suggestions for an Item\n";
+        cout << " 16. Suggestion Inbox (" << inboxSize(worker) << " new)\n";
+        cout << " 17. Exit\n";
 
         cout << "------------------------------------------------------------------------------------------------------------------------------\n";
-        cout << "Select an option (1-12): ";
+        cout << "Select an option (1-17): ";
 
         cin >> choice;
 
         // Validate input
-        if (cin.fail() || choice < 1 || choice > 12)
+        if (cin.fail() || choice < 1 || choice > 17)
  {
-            cout << "Invalid input! Please enter a number between 1 and 11.\n";
+            cout << "Invalid input! Please enter a number between 1 and 17.\n";
             cin.clear();
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
             continue;
@@ -1586,23 +6421,513 @@ void mainMenu(Item*& items, int& itemCount, int& capacity, int& nextID, const ch
 
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
+        // The background matcher waits until this action is done
+        lock_guard<mutex> busy(worker.dataLock);
         switch (choice) {
             case 1: showHelp(); break;
-            case 2: addLostItem(items, itemCount, capacity, nextID, filename, file); break;
-            case 3: addFoundItem(items, itemCount, capacity, nextID, filename, file); break;
+            case 2: addLostItem(items, itemCount, capacity, index, alerts, worker, nextID, filename, file); break;
+            case 3: addFoundItem(items, itemCount, capacity, index, alerts, worker, nextID, filename, file); break;
             case 4: viewFromFile(filename, file); break;
-            case 5: updateItem(items, itemCount, filename, nextID, file); break;
-            case 6: filterSearchMenu(items, itemCount); break;
-            case 7: deleteItem(items, itemCount, nextID, filename, file); break;
-            case 8: markAsClaimed(items, itemCount, filename, nextID, file); break;
-            case 9: markItemAsMatched(items, itemCount, nextID, filename, file); break;
-            case 10: sortMenu(items, itemCount, filename, nextID, file); break;
-            case 11: clearAllItems(items, itemCount, nextID, filename); break;
-            case 12: cout << "Exiting...\n"; break;
+            case 5: updateItem(items, itemCount, index, alerts, worker, filename, nextID, file); break;
+            case 6: filterSearchMenu(items, itemCount, index, cache); break;
+            case 7: deleteItem(items, itemCount, index, suggestions, nextID, filename, file); break;
+            case 8: markAsClaimed(items, itemCount, index, filename, nextID, file); break;
+            case 9: markItemAsMatched(items, itemCount, index, suggestions, nextID, filename, file); break;
+            case 10: sortMenu(items, itemCount, index, filename, nextID, file); break;
+            case 11:
+                clearAllItems(items, itemCount, index, nextID, filename);
+                if (itemCount == 0) { // IDs start over, old suggestions would point at new items
+                    suggestions.lists.clear();
+                    saveSuggestions(suggestions);
+                    lock_guard<mutex> lock(worker.queueLock);
+                    worker.queue.clear();
+                    worker.inbox.clear();
+                }
+                break;
+            case 12: alertsMenu(alerts, alertsFile); break;
+            case 13: displayStatistics(index, itemCount); pause(); break;
+            case 14: batchMatchMenu(items, itemCount, index, matching, suggestions, nextID, filename, proposalsFile, file); break;
+            case 15: showSuggestions(items, itemCount, index, suggestions, nextID, filename, file); break;
+            case 16: suggestionInbox(items, itemCount, index, matching, suggestions, worker, nextID, filename, file); break;
+            case 17: cout << "Exiting...\n"; break;
+        }
+
+
+  } while (choice != 17);
+}
+
+
+
+
+
+
+// Benchmarks
+// Synthetic data and timings, run with --bench. They never touch items.bin.
+
+const char* const BENCH_NAMES[] = {
+    "iPhone", "Wallet", "Backpack", "Umbrella", "Passport", "Laptop", "Keys", "Jacket",
+    "Headphones", "Water Bottle", "Student ID", "Sunglasses", "Charger", "Notebook", "Watch"
+};
+const char* const BENCH_COLORS[] = {"black", "brown", "red", "blue", "silver", "green", "white"};
+const char* const BENCH_DETAILS[] = {
+    "with a cracked screen", "leather", "with a name tag", "small scratch on the side",
+    "in a plastic case", "with stickers", "almost new", "zipper is broken"
+};
+const char* const BENCH_LOCATIONS[] = {
+    "Library", "Cafeteria", "Gym", "Main Hall", "Parking Lot", "Bus Stop", "Lab 3", "Dormitory"
+};
+const int BENCH_NAME_COUNT = 15;
+const int BENCH_COLOR_COUNT = 7;
+const int BENCH_DETAIL_COUNT = 8;
+const int BENCH_LOCATION_COUNT = 8;
+
+void generateSyntheticItems(Item items[], int count, unsigned seed) {
+    mt19937 rng(seed);
+    int firstDay = daysFromCivil(2025, 1, 1);
+
+    for (int i = 0; i < count; i++) {
+        string name = BENCH_NAMES[rng() % BENCH_NAME_COUNT];
+        string color = BENCH_COLORS[rng() % BENCH_COLOR_COUNT];
+
+        items[i].id = 100 + i;
+        items[i].name = (rng() % 2) ? color + " " + name : name + " " + to_string(rng() % 20);
+        items[i].category = CATEGORIES[rng() % CATEGORY_COUNT];
+        items[i].description = color + " " + toLowerCase(name) + " " + BENCH_DETAILS[rng() % BENCH_DETAIL_COUNT];
+        items[i].date = firstDay + static_cast<int>(rng() % 365);
+        items[i].location = BENCH_LOCATIONS[rng() % BENCH_LOCATION_COUNT];
+        items[i].status = (rng() % 2) ? "Lost" : "Found";
+        items[i].matched = 0;
+        items[i].claimed = 0;
+        items[i].matchedItemID = -1;
+        items[i].personName = "";
+        items[i].personContact = "";
+    }
+}
+
+void benchmarkFuzzySearch(int itemCount) {
+    Item* items = new Item[itemCount];
+    int* results = new int[itemCount];
+    ItemIndex index;
+    generateSyntheticItems(items, itemCount, 31);
+    rebuildIndex(index, items, itemCount);
+
+    const char* const QUERIES[] = {"iphnoe", "wallett", "backpak", "umbrela", "pasport"};
+    cout << "\n--- Fuzzy name search, " << itemCount << " items, k = 2 ---\n";
+    cout << "query      exact(ms) hits  fuzzy(ms) hits  full-scan fuzzy(ms)\n";
+
+    for (int q = 0; q < 5; q++) {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        ResultCursor exact = searchByName(items, itemCount, QUERIES[q]);
+        int exactHits = drainCursor(exact, results);
+        double exactMs = elapsedMs(start);
+
+        start = chrono::steady_clock::now();
+        ResultCursor fuzzy = searchByNameFuzzy(items, itemCount, index, QUERIES[q], 2);
+        int fuzzyHits = drainCursor(fuzzy, results);
+        double fuzzyMs = elapsedMs(start);
+
+        start = chrono::steady_clock::now();
+        ResultCursor scan = searchByNameFuzzy(items, itemCount, index, QUERIES[q], 2, false);
+        drainCursor(scan, results);
+        double scanMs = elapsedMs(start);
+
+        printf("%-10s %9.2f %5d %9.2f %5d %10.2f\n", QUERIES[q], exactMs, exactHits, fuzzyMs, fuzzyHits, scanMs);
+    }
+
+    delete[] results;
+    delete[] items;
+}
+
+void benchmarkPhraseSearch(int itemCount) {
+    Item* items = new Item[itemCount];
+    int* results = new int[itemCount];
+    ItemIndex index;
+    generateSyntheticItems(items, itemCount, 37);
+    rebuildIndex(index, items, itemCount);
+
+    const char* const PHRASES[] = {"black leather", "black NEAR/2 leather", "cracked screen", "red NEAR/4 broken", "name tag"};
+    cout << "\n--- Phrase search in descriptions, " << itemCount << " items ---\n";
+    cout << "phrase                  substring(ms) hits  positional(ms) hits\n";
+
+    for (int q = 0; q < 5; q++) {
+        PhraseQuery phrase;
+        string error;
+        parsePhrase(PHRASES[q], phrase, error);
+
+        // The substring scan can only test the words as one literal string
+        string literal;
+        for (size_t t = 0; t < phrase.terms.size(); t++) literal += (t ? " " : "") + phrase.terms[t];
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        ResultCursor scan = scanCursor(items, itemCount, FIELD_DESCRIPTION, literal);
+        int scanHits = drainCursor(scan, results);
+        double scanMs = elapsedMs(start);
+
+        start = chrono::steady_clock::now();
+        ResultCursor positional = searchByPhrase(index, phrase);
+        int hits = drainCursor(positional, results);
+        double positionalMs = elapsedMs(start);
+
+        printf("%-22s %13.2f %6d %14.2f %6d\n", PHRASES[q], scanMs, scanHits, positionalMs, hits);
+    }
+
+    delete[] results;
+    delete[] items;
+}
+
+// Alert texts are queries: check how a few tricky ones split into predicates
+void checkQuerySplitting() {
+    struct SplitCase { const char* text; int predicates; bool anyOf; };
+    const SplitCase CASES[] = {
+        {"description~\"black and white\"", 1, false},
+        {"location~Library and Cafe", 1, false},
+        {"description~\"keys OR wallet\" AND status=Lost", 2, false},
+        {"name~phone OR name~tablet OR name~laptop", 3, true},
+        {"status=Lost AND category=Electronics", 2, false},
+    };
+    const int CASE_COUNT = sizeof(CASES) / sizeof(CASES[0]);
+    int passed = 0;
+    for (int i = 0; i < CASE_COUNT; i++) {
+        Query query;
+        string error;
+        bool ok = parseQuery(CASES[i].text, query, error) &&
+                  static_cast<int>(query.predicates.size()) == CASES[i].predicates && query.anyOf == CASES[i].anyOf;
+        if (ok) passed++;
+        else cout << "  query '" << CASES[i].text << "' split wrongly\n";
+    }
+    printf("query splitting: %d of %d as expected\n", passed, CASE_COUNT);
+}
+
+void benchmarkStandingAlerts(int alertCount, int itemCount) {
+    AlertRegistry registry;
+    mt19937 rng(41);
+    for (int i = 0; i < alertCount; i++) {
+        string name = toLowerCase(BENCH_NAMES[rng() % BENCH_NAME_COUNT]);
+        string text;
+        switch (i % 4) {
+            case 0: text = "status=Found AND description~" + string(BENCH_COLORS[rng() % BENCH_COLOR_COUNT]) + " " + name; break;
+            case 1: text = "category=" + string(CATEGORIES[rng() % CATEGORY_COUNT]) + " AND name~" + name; break;
+            case 2: text = "location=" + string(BENCH_LOCATIONS[rng() % BENCH_LOCATION_COUNT]) + " AND description~" + BENCH_DETAILS[rng() % BENCH_DETAIL_COUNT]; break;
+            default: text = "name~" + name + " " + to_string(rng() % 20) + " OR description~" + name + " " + BENCH_DETAILS[rng() % BENCH_DETAIL_COUNT]; break;
         }
+        string error;
+        addAlert(registry, text, 0, error);
+    }
+
+    Item* items = new Item[itemCount];
+    generateSyntheticItems(items, itemCount, 43);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    long checked = 0, fired = 0;
+    for (int i = 0; i < itemCount; i++) {
+        vector<int> candidates = alertCandidates(registry, items[i]);
+        checked += static_cast<long>(candidates.size());
+        for (size_t c = 0; c < candidates.size(); c++)
+            fired += itemMatchesQuery(items[i], registry.alerts[candidates[c]].query);
+    }
+    double anchoredMs = elapsedMs(start);
+
+    start = chrono::steady_clock::now();
+    long firedAll = 0;
+    for (int i = 0; i < itemCount; i++) {
+        for (size_t a = 0; a < registry.alerts.size(); a++)
+            firedAll += itemMatchesQuery(items[i], registry.alerts[a].query);
+    }
+    double allMs = elapsedMs(start);
+
+    cout << "\n--- Standing alerts, " << alertCount << " alerts, " << itemCount << " inserts ---\n";
+    checkQuerySplitting();
+    printf("anchored:  %8.2f ms  %8.1f alerts checked per insert  %ld fired\n", anchoredMs, double(checked) / itemCount, fired);
+    printf("check all: %8.2f ms  %8d alerts checked per insert  %ld fired\n", allMs, alertCount, firedAll);
+
+    delete[] items;
+}
+
+void benchmarkBatchMatching(int itemCount) {
+    Item* items = new Item[itemCount];
+    ItemIndex index;
+    generateSyntheticItems(items, itemCount, 47);
+    rebuildIndex(index, items, itemCount);
+    MatchSettings settings = defaultMatchSettings();
+    settings.dateWindowDays = 14;
+
+    cout << "\n--- Batch matching, " << itemCount << " items, +/-14 day blocks ---\n";
+    cout << "threads  pairs scored  proposals  time(ms)\n";
+    int counts[] = {1, 2, 4, defaultThreadCount()};
+    for (int c = 0; c < 4; c++) {
+        if (c == 3 && counts[3] <= 4) break;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        long pairs = 0;
+        vector<MatchProposal> proposals = proposeMatches(items, itemCount, index, settings, counts[c], pairs);
+        printf("%7d %13ld %10d %9.1f\n", counts[c], pairs, static_cast<int>(proposals.size()), elapsedMs(start));
+    }
+
+    delete[] items;
+}
+
+// Synthetic descriptions with a per-item tail, so most are not exact duplicates
+void addDescriptionNoise(Item items[], int count, unsigned seed) {
+    const char* const EXTRAS[] = {"sticker", "keychain", "initials", "receipt", "dent", "strap", "logo", "charm"};
+    mt19937 rng(seed);
+    for (int i = 0; i < count; i++)
+        items[i].description += " " + string(EXTRAS[rng() % 8]) + " " + to_string(rng() % 1000);
+}
+
+// Exact Jaccard similarity of the shingle sets that minHashOf samples
+double shingleJaccard(const vector<unsigned long long>& a, const vector<unsigned long long>& b) {
+    vector<unsigned long long> common;
+    set_intersection(a.begin(), a.end(), b.begin(), b.end(), back_inserter(common));
+    size_t all = a.size() + b.size() - common.size();
+    return all == 0 ? 0.0 : static_cast<double>(common.size()) / all;
+}
+
+vector<unsigned long long> shingleSetOf(const string& text) {
+    vector<string> words = tokensOf(text);
+    string joined;
+    for (size_t i = 0; i < words.size(); i++) joined += (i ? " " : "") + words[i];
+    vector<unsigned long long> set;
+    for (size_t i = 0; i + SHINGLE_LENGTH <= joined.size(); i++) {
+        unsigned long long shingle = 14695981039346656037ULL;
+        for (size_t j = i; j < i + SHINGLE_LENGTH; j++)
+            shingle = (shingle ^ static_cast<unsigned char>(joined[j])) * 1099511628211ULL;
+        set.push_back(shingle);
+    }
+    sort(set.begin(), set.end());
+    set.erase(unique(set.begin(), set.end()), set.end());
+    return set;
+}
+
+void benchmarkRankedSearch(int itemCount) {
+    Item* items = new Item[itemCount];
+    ItemIndex index;
+    generateSyntheticItems(items, itemCount, 53);
+    addDescriptionNoise(items, itemCount, 59);
+    items[0].name = "Grandfather Clock"; // a word that is known, but only from a name
+    rebuildIndex(index, items, itemCount);
+
+    const char* const QUERIES[] = {"blue umbrella with a name tag", "silver laptop cracked screen",
+                                   "leather passport initials 417", "keys sticker 42", "black", "grandfather"};
+    cout << "\n--- Ranked description search, " << itemCount << " items, top " << RANKED_RESULT_LIMIT << " ---\n";
+    cout << "query                          full(ms)   scored  WAND(ms)   scored  postings read/skipped  same\n";
+
+    for (int q = 0; q < 6; q++) {
+        PruneStats full, wand;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        ResultCursor all = searchRanked(index, itemCount, QUERIES[q], RANKED_RESULT_LIMIT, full, false);
+        double fullMs = elapsedMs(start);
+
+        start = chrono::steady_clock::now();
+        ResultCursor pruned = searchRanked(index, itemCount, QUERIES[q], RANKED_RESULT_LIMIT, wand);
+        double wandMs = elapsedMs(start);
+
+        // Equal scores may come out in another order, so compare the scores
+        TermVector query = descriptionVector(index, itemCount, knownTermsOf(index.normalizer, QUERIES[q]));
+        bool same = all.list.size() == pruned.list.size();
+        for (size_t i = 0; same && i < all.list.size(); i++) {
+            double a = termCosine(query, descriptionVector(index, itemCount, index.itemTerms[all.list[i]].description));
+            double b = termCosine(query, descriptionVector(index, itemCount, index.itemTerms[pruned.list[i]].description));
+            same = fabs(a - b) < 1e-9;
+        }
+
+        printf("%-30s %8.2f %8ld %9.2f %8ld %10ld/%-10ld  %s\n", QUERIES[q], fullMs, full.scored, wandMs, wand.scored,
+               wand.postingsRead, wand.postingsSkipped, same ? "yes" : "NO");
+    }
+
+    // Top-k matching: every lost item against its block, with and without bounds
+    int matchItems = min(itemCount, 20000);
+    rebuildIndex(index, items, matchItems);
+    MatchSettings settings = defaultMatchSettings();
+    settings.dateWindowDays = 14;
+    settings.lshBlockLimit = 0;
+    settings.trace = false;
+
+    PruneStats full, pruned;
+    double fullMs = 0.0, prunedMs = 0.0;
+    int lostItems = 0, differ = 0;
+    for (int i = 0; i < matchItems; i += 10) {
+        if (statusIndexOf(items[i].status) != 0) continue;
+        lostItems++;
+        int fullCount = 0, prunedCount = 0;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        MatchCandidate* a = findPotentialMatches(items, matchItems, index, settings, items[i], fullCount, &full, false);
+        fullMs += elapsedMs(start);
+        start = chrono::steady_clock::now();
+        MatchCandidate* b = findPotentialMatches(items, matchItems, index, settings, items[i], prunedCount, &pruned);
+        prunedMs += elapsedMs(start);
+
+        bool same = fullCount == prunedCount;
+        for (int m = 0; same && m < fullCount; m++) same = fabs(a[m].score - b[m].score) < 1e-9;
+        if (!same) differ++;
+        delete[] a;
+        delete[] b;
+    }
+    cout << "\n--- Top-" << settings.topK << " matching, " << lostItems << " lost items of " << matchItems
+         << ", +/-14 day blocks ---\n";
+    printf("all candidates:   %8.3f ms/item  %8.1f scored/item\n", fullMs / lostItems, double(full.scored) / lostItems);
+    printf("bounded:          %8.3f ms/item  %8.1f scored/item  %8.1f skipped/item  %d result(s) differ\n",
+           prunedMs / lostItems, double(pruned.scored) / lostItems, double(pruned.skipped) / lostItems, differ);
+
+    delete[] items;
+}
+
+void benchmarkSpatialGrid(int pointCount, int queryCount) {
+    const double CENTER_LAT = 51.50, CENTER_LON = -0.12, SPAN = 0.18;   // about 20 km square
+    mt19937 rng(61);
+    uniform_real_distribution<double> offset(-SPAN / 2, SPAN / 2);
+    vector<double> lat(pointCount), lon(pointCount);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    GeoGrid grid;
+    for (int i = 0; i < pointCount; i++) {
+        lat[i] = CENTER_LAT + offset(rng);
+        lon[i] = CENTER_LON + offset(rng);
+        gridAdd(grid, i, lat[i], lon[i]);
+    }
+    double buildMs = elapsedMs(start);
+
+    cout << "\n--- Spatial grid, " << pointCount << " points, " << grid.cells.size() << " cells ---\n";
+    printf("build: %.1f ms\n", buildMs);
+
+    double radiusMs = 0.0, nearestMs = 0.0, scanMs = 0.0;
+    long hits = 0;
+    int wrong = 0, checked = 0;
+    for (int q = 0; q < queryCount; q++) {
+        double qLat = CENTER_LAT + offset(rng), qLon = CENTER_LON + offset(rng);
+        if (q % 40 == 20) {   // now and then a point far outside the items' area
+            qLat += 1.0;
+            qLon += 1.0;
+        }
+
+        start = chrono::steady_clock::now();
+        vector<pair<double, int> > within = gridWithin(grid, qLat, qLon, 200.0);
+        radiusMs += elapsedMs(start);
+        hits += static_cast<long>(within.size());
+
+        start = chrono::steady_clock::now();
+        vector<pair<double, int> > nearest = gridNearest(grid, qLat, qLon, 5);
+        nearestMs += elapsedMs(start);
+
+        // Brute force on a few queries, to check both answers
+        if (q % 20 != 0) continue;
+        start = chrono::steady_clock::now();
+        vector<pair<double, int> > all(pointCount);
+        for (int i = 0; i < pointCount; i++) all[i] = make_pair(geoDistanceMeters(qLat, qLon, lat[i], lon[i]), i);
+        partial_sort(all.begin(), all.begin() + 5, all.end(), nearerPoint);
+        long inside = 0;
+        for (int i = 0; i < pointCount; i++) inside += (all[i].first <= 200.0);
+        scanMs += elapsedMs(start);
+        checked++;
+        bool same = inside == static_cast<long>(within.size()) && nearest.size() == 5;
+        for (int i = 0; same && i < 5; i++) same = nearest[i].second == all[i].second;
+        if (!same) wrong++;
+    }
+
+    printf("radius 200 m: %8.4f ms/query  %6.1f hits/query\n", radiusMs / queryCount, double(hits) / queryCount);
+    printf("5 nearest:    %8.4f ms/query\n", nearestMs / queryCount);
+    printf("full scan:    %8.4f ms/query  (%d checked, %d differ)\n", checked ? scanMs / checked : 0.0, checked, wrong);
+}
+
+void benchmarkSimilarItems(int itemCount, int queryCount) {
+    Item* items = new Item[itemCount];
+    ItemIndex index;
+    generateSyntheticItems(items, itemCount, 53);
+    addDescriptionNoise(items, itemCount, 59);
+    rebuildIndex(index, items, itemCount);
+
+    vector<vector<unsigned long long> > sets(itemCount);
+    for (int i = 0; i < itemCount; i++) sets[i] = shingleSetOf(items[i].description);
+
+    // Queries are reworded copies of existing descriptions: one word dropped
+    mt19937 rng(61);
+    const double THRESHOLD = 0.5;
+    long truePairs = 0, foundPairs = 0, candidates = 0;
+    double lshMs = 0, scanMs = 0;
+
+    for (int q = 0; q < queryCount; q++) {
+        vector<string> words = tokensOf(items[rng() % itemCount].description);
+        words.erase(words.begin() + rng() % words.size());
+        string text;
+        for (size_t i = 0; i < words.size(); i++) text += (i ? " " : "") + words[i];
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        MinHashSignature sig = minHashOf(text);
+        Bitmap near = similarDescriptions(index, sig);
+        lshMs += elapsedMs(start);
+        candidates += bitmapCardinality(near);
+
+        start = chrono::steady_clock::now();
+        vector<unsigned long long> querySet = shingleSetOf(text);
+        vector<int> truth;
+        for (int i = 0; i < itemCount; i++) {
+            if (shingleJaccard(querySet, sets[i]) >= THRESHOLD) truth.push_back(i);
+        }
+        scanMs += elapsedMs(start);
+
+        truePairs += static_cast<long>(truth.size());
+        for (size_t i = 0; i < truth.size(); i++) foundPairs += bitmapContains(near, truth[i]);
+    }
+
+    cout << "\n--- Similar descriptions, " << itemCount << " items, " << queryCount << " queries, Jaccard >= 0.5 ---\n";
+    printf("LSH buckets: %8.3f ms/query  %8.1f candidates/query  recall %.3f (%ld of %ld)\n",
+           lshMs / queryCount, double(candidates) / queryCount,
+           truePairs ? double(foundPairs) / truePairs : 1.0, foundPairs, truePairs);
+    printf("full scan:   %8.3f ms/query  %8d candidates/query  recall 1.000\n", scanMs / queryCount, itemCount);
+
+    delete[] items;
+}
 
+int runBenchmarks() {
+    benchmarkFuzzySearch(200000);
+    benchmarkPhraseSearch(200000);
+    benchmarkStandingAlerts(5000, 2000);
+    benchmarkBatchMatching(5000);
+    benchmarkSimilarItems(100000, 100);
+    benchmarkRankedSearch(200000);
+    benchmarkSpatialGrid(1000000, 1000);
+    return 0;
+}
+
+
+
+
+
+
+// Command Line Interface
+int runCommandLine(int argc, char* argv[], Item items[], int itemCount, const ItemIndex& index,
+                   const MatchSettings& matching, const char* proposalsFile) {
+    string command = argv[1];
 
-  } while (choice != 12);
+    if (command == "--query" && argc == 3) {
+        Query query;
+        string error;
+        if (!parseQuery(argv[2], query, error)) {
+            cout << "Invalid query: " << error << "\n";
+            return 1;
+        }
+        planQuery(index, itemCount, query);
+        explainQuery(query);
+
+        int* results = new int[itemCount > 0 ? itemCount : 1];
+        int count = runQuery(items, itemCount, index, query, results);
+        displayResults(items, results, count, &index);
+        delete[] results;
+        return 0;
+    }
+
+    if (command == "--bench" && argc == 2)
+        return runBenchmarks();
+
+    if (command == "--batch-match" && argc == 2) {
+        runBatchMatching(items, itemCount, index, matching, proposalsFile);
+        return 0;
+    }
+
+    cout << "Usage:\n";
+    cout << "  " << argv[0] << "                  start the interactive menu\n";
+    cout << "  " << argv[0] << " --query \"<q>\"    run a query, e.g. \"status=Lost AND category=Keys\"\n";
+    cout << "  " << argv[0] << " --bench          run the search benchmarks on synthetic data\n";
+    cout << "  " << argv[0] << " --batch-match    propose matches for all unmatched items (" << proposalsFile << ")\n";
+    return command == "--help" ? 0 : 1;
 }
 
 
@@ -1611,21 +6936,48 @@ void mainMenu(Item*& items, int& itemCount, int& capacity, int& nextID, const ch
 
 
 // Main Function
-int main() {
+int main(int argc, char* argv[]) {
     fstream file;
     const char* filename = "items.bin";
+    const char* alertsFile = "alerts.txt";
+    const char* matchingFile = "matching.cfg";
+    const char* proposalsFile = "match_proposals.txt";
+    const char* synonymsFile = "synonyms.txt";
+    const char* locationsFile = "locations.txt";
 
     int itemCount = 0, nextID = 100, capacity = 10;
     Item* items = new Item[capacity];
+    ItemIndex index;
+    QueryCache cache;
+    AlertRegistry alerts;
+    MatchSettings matching = defaultMatchSettings();
+    SuggestionStore suggestions;
+    suggestions.filename = "suggestions.txt";
+    MatchWorker worker;
 
    
     loadFromFile(file, items, itemCount, capacity, nextID, filename);
+    loadSynonyms(index.normalizer, synonymsFile);
+    loadLocations(index.locations, locationsFile);
+    rebuildIndex(index, items, itemCount);
+    loadAlerts(alerts, alertsFile);
+    loadMatchSettings(matching, matchingFile);
+
+    // Non-interactive use: run one command and exit
+    if (argc > 1) {
+        int status = runCommandLine(argc, argv, items, itemCount, index, matching, proposalsFile);
+        delete[] items;
+        return status;
+    }
+    loadSuggestions(suggestions, items, itemCount, index, matching);
     
     displayWelcomeMessage();
     pause();
 //    cout << "Items loaded: " << itemCount << ", Next ID: " << nextID << "\n";
 
-    mainMenu(items, itemCount, capacity, nextID, filename, file);
+    startMatchWorker(worker, items, itemCount, index, matching, suggestions);
+    mainMenu(items, itemCount, capacity, index, cache, alerts, matching, suggestions, worker, nextID, filename, alertsFile, proposalsFile, file);
+    stopMatchWorker(worker);
 
     delete[] items;
     return 0;